@@ -18,7 +18,22 @@ namespace chrono = std::chrono;
 typedef chrono::high_resolution_clock hrc;
 typedef chrono::duration<double, std::milli> duration_ms;
 
-void benchmark(const std::string &trtFilePath) {
+// 반복 측정에서 얻은 config.toml [latency]의 engine model 한 줄.
+// static batch engine은 유효 batch 수와 무관하게 전체 batch를 실행하므로 exec 시간 (median)을
+// fixed_ms로 두고 per_item_ms는 0으로 출력한다. (fit 하지 않음)
+std::string fitLatencyModel(
+    const std::string &engineName,
+    std::vector<double> execMs,
+    double copyBytes,
+    double copyMs) {
+    std::sort(execMs.begin(), execMs.end());
+    const double fixedMs = execMs.empty() ? 0.0 : execMs[execMs.size() / 2];
+    const double copyGBps = copyMs > 0.0 ? copyBytes / (copyMs * 1e6) : 0.0;
+    return engineName + " = { fixed_ms = " + std::to_string(fixedMs) +
+           ", per_item_ms = 0.0, copy_gbps = " + std::to_string(copyGBps) + " }";
+}
+
+std::string benchmark(const std::string &trtFilePath) {
     // ------------
     // Load Engine
     // ------------
@@ -56,8 +71,14 @@ void benchmark(const std::string &trtFilePath) {
     UniquePtrTRT<nvinfer1::IExecutionContext> context =
         UniquePtrTRT<nvinfer1::IExecutionContext>(engine->createExecutionContext());
 
+    // latency model 용. 첫 iteration (warm-up)은 제외한다.
+    std::vector<double> execMsList;
+    double copyBytes = 0.0;
+    double copyMs = 0.0;
+
     // Iterate Iteration
     for (int iter = 0; iter < 10; ++iter) {
+        const bool bMeasure = iter > 0;
 
         std::cout << std::endl;
         const hrc::time_point t1_total = hrc::now();
@@ -86,6 +107,11 @@ void benchmark(const std::string &trtFilePath) {
                 const hrc::time_point t2_upload = hrc::now();
                 const duration_ms duration_upload = t2_upload - t1_upload;
                 std::cout << "upload_time (ms): " << duration_upload.count() << std::endl;
+                if (bMeasure) {
+                    copyBytes += static_cast<double>(vol) *
+                                 getTypeSize(engine->getBindingDataType(idx));
+                    copyMs += duration_upload.count();
+                }
             }
         }
 
@@ -96,6 +122,9 @@ void benchmark(const std::string &trtFilePath) {
         const hrc::time_point t2_exec = hrc::now();
         const duration_ms duration_exec = t2_exec - t1_exec;
         std::cout << "exec_time (ms): " << duration_exec.count() << std::endl;
+        if (bMeasure) {
+            execMsList.push_back(duration_exec.count());
+        }
 
         // Show dummy outputs (Device -> Host)
         const hrc::time_point t1_download_all = hrc::now();
@@ -110,6 +139,11 @@ void benchmark(const std::string &trtFilePath) {
                 const hrc::time_point t2_download = hrc::now();
                 const duration_ms duration_download = t2_download - t1_download;
                 std::cout << "download_time (ms): " << duration_download.count() << std::endl;
+                if (bMeasure) {
+                    copyBytes += static_cast<double>(vol) *
+                                 getTypeSize(engine->getBindingDataType(idx));
+                    copyMs += duration_download.count();
+                }
 
                 int printLen = std::min(int(hostOutBuffer.size()), 10);
                 for (int p = 0; p < printLen; ++p) {
@@ -126,6 +160,8 @@ void benchmark(const std::string &trtFilePath) {
         const duration_ms duration_total = t2_total - t1_total;
         std::cout << "total_time (ms): " << duration_total.count() << std::endl;
     }
+
+    return fitLatencyModel(fs::path{trtFilePath}.stem().string(), execMsList, copyBytes, copyMs);
 }
 
 int main() {
@@ -146,10 +182,17 @@ int main() {
     }
 
     // Build each onnx
+    std::vector<std::string> latencyModels;
     for (const auto &elem : lines) {
         std::cout << std::endl << std::endl << std::endl << std::endl;
         std::cout << elem << std::endl << std::endl;
-        benchmark(elem);
+        latencyModels.push_back(benchmark(elem));
     }
     std::cout << std::endl << std::endl << std::endl << std::endl;
+
+    // taillight config.toml의 [latency]에 붙여 넣는다.
+    std::cout << "latency model" << std::endl;
+    for (const auto &elem : latencyModels) {
+        std::cout << elem << std::endl;
+    }
 }
@@ -1,6 +1,7 @@
 #include <experimental/filesystem> // gcc 8부터 experimental 뗄 수 있다. CMAKE의 link도 나중에 같이 떼주도록 하자.
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -9,12 +10,14 @@
 #include <cuda_runtime_api.h>
 
 #include "trt_utils/common.h"
+#include "trt_utils/inputAdapter.h"
 
 namespace fs = std::experimental::filesystem;
 
 struct SampleParams {
     bool int8{false}; //!< Allow runnning the network in Int8 mode.
     bool fp16{true};  //!< Allow running the network in FP16 mode.
+    bool byteInput{false}; //!< float input 대신 raw BGR byte input (InputAdapter 추가)
     std::string onnxFilePath;
     std::string engineFilePath;
 };
@@ -38,6 +41,13 @@ void build(const SampleParams &params) {
         params.onnxFilePath.c_str(),
         static_cast<int>(nvinfer1::ILogger::Severity::kWARNING));
 
+    // byte input이면 cast, channel swap, normalize layer를 앞에 추가.
+    // (Spec은 taillight agent의 float preprocess와 같은 기본값)
+    InputAdapter::PrefixWeights adapterWeights;
+    if (params.byteInput) {
+        InputAdapter::prepend(*network, InputAdapter::Spec{}, adapterWeights);
+    }
+
     // -------------
     // Build engine
     // -------------
@@ -46,6 +56,9 @@ void build(const SampleParams &params) {
     if (params.fp16) {
         config->setFlag(nvinfer1::BuilderFlag::kFP16);
     }
+    if (params.byteInput) {
+        InputAdapter::setBuilderFlags(*config);
+    }
     /*
     builder->setMaxBatchSize(params.batchSize);
     if (params.int8)
@@ -74,6 +87,7 @@ void build(const SampleParams &params) {
 int main() {
 
     // Get Onnx lists
+    // 한 줄에 "onnx 경로 [u8]". u8이면 raw BGR byte input을 받는 engine으로 build.
     const std::string homeDir = std::getenv("HOME");
     std::ifstream f("./InputOnnxList.txt");
     std::string line;
@@ -89,8 +103,18 @@ int main() {
 
     // Build each onnx
     for (const auto &elem : lines) {
+        std::istringstream tokens{elem};
         SampleParams params;
-        params.onnxFilePath = elem;
+        tokens >> params.onnxFilePath;
+        std::string option;
+        while (tokens >> option) {
+            if (option == "u8") {
+                params.byteInput = true;
+            } else {
+                std::cout << "Unknown option: " << option << std::endl;
+                exit(1);
+            }
+        }
 
         build(params);
     }
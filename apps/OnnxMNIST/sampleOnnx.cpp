@@ -10,6 +10,7 @@
 #include <cuda_runtime_api.h>
 
 #include "trt_utils/bufferManager.h"
+#include "trt_utils/simdKernels.h"
 
 struct SampleParams {
     bool int8{false}; //!< Allow runnning the network in Int8 mode.
@@ -110,9 +111,9 @@ void SampleOnnxMNIST::infer() {
     readPGMFile(mParams.inputFilePath, fileData.data(), inputH, inputW);
 
     std::vector<float> hostInBuffer(inputH * inputW);
-    for (int i = 0; i < inputH * inputW; ++i) {
-        hostInBuffer[i] = 1.0 - float(fileData[i] / 255.0);
-    }
+    // 1 - x / 255
+    SimdKernels::u8ToF32(
+        fileData.data(), hostInBuffer.data(), inputH * inputW, -1.0f / 255.0f, 1.0f);
 
     // ----------------------
     // Copy (Host -> Device)
@@ -13,6 +13,7 @@
 #include <cuda_runtime_api.h>
 
 #include "trt_utils/bufferManager.h"
+#include "trt_utils/simdKernels.h"
 
 namespace fs = std::experimental::filesystem;
 
@@ -163,32 +164,18 @@ void TaillightInferenceAgent::inferTest() {
 
         std::vector<float> input1(8 * 3 * 112 * 112);
 
-        // first unet
-        int idx = 0;
+        // first unet (HWC -> CHW)
         for (int t = 0; t < 8; ++t) {
-            for (int c = 0; c < 3; ++c) {
-                for (int h = 0; h < 112; ++h) {
-                    for (int w = 0; w < 112; ++w) {
-                        input1[idx] = imgSeq[t].at<cv::Vec3f>(h, w)[c];
-                        idx += 1;
-                    }
-                }
-            }
+            SimdKernels::hwcToChw(
+                imgSeq[t].ptr<float>(), &input1[t * 3 * 112 * 112], 112 * 112, 3);
         }
         output1 = infer(0, input1);
         input2.insert(input2.end(), output1.begin(), output1.end());
 
-        // second unet
-        idx = 0;
+        // second unet (HWC -> CHW)
         for (int t = 8; t < 16; ++t) {
-            for (int c = 0; c < 3; ++c) {
-                for (int h = 0; h < 112; ++h) {
-                    for (int w = 0; w < 112; ++w) {
-                        input1[idx] = imgSeq[t].at<cv::Vec3f>(h, w)[c];
-                        idx += 1;
-                    }
-                }
-            }
+            SimdKernels::hwcToChw(
+                imgSeq[t].ptr<float>(), &input1[(t - 8) * 3 * 112 * 112], 112 * 112, 3);
         }
         output1 = infer(0, input1);
         input2.insert(input2.end(), output1.begin(), output1.end());
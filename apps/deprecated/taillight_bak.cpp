@@ -14,6 +14,7 @@
 #include <cuda_runtime_api.h>
 
 #include "trt_utils/bufferManager.h"
+#include "trt_utils/simdKernels.h"
 
 namespace fs = std::experimental::filesystem;
 namespace chrono = std::chrono;
@@ -127,16 +128,10 @@ std::vector<std::string> TaillightInferenceAgent::infer(std::vector<std::string>
         // -------------------
         // Prepare Input Data
         // -------------------
-        int idx = 0;
+        // HWC -> CHW
         for (int t = iSeq; t < iSeq + 16; ++t) {
-            for (int c = 0; c < 3; ++c) {
-                for (int h = 0; h < 112; ++h) {
-                    for (int w = 0; w < 112; ++w) {
-                        hostInBuffer[idx] = imgSeq[t].at<cv::Vec3f>(h, w)[c];
-                        idx += 1;
-                    }
-                }
-            }
+            SimdKernels::hwcToChw(
+                imgSeq[t].ptr<float>(), &hostInBuffer[(t - iSeq) * 3 * 112 * 112], 112 * 112, 3);
         }
         // std::fill(hostInBuffer.begin(), hostInBuffer.end(), 1.0); // dummy test
 
@@ -1,5 +1,4 @@
 #include "taillight/TailRecogManager.hpp"
-#include "taillight/instance.hpp"
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -27,28 +26,127 @@ int main(int argc, char **argv) {
 
     // Read config file
     auto data = toml::parse("./config.toml");
-    const std::array<float, 16> RT_vals = toml::find<std::array<float, 16>>(data, "calib", "RT");
-    const std::array<float, 16> RL_vals = toml::find<std::array<float, 16>>(data, "calib", "RL");
-    const std::array<float, 9> K_vals = toml::find<std::array<float, 9>>(data, "calib", "K");
 
-    const CalibParams calib_params{RT_vals, RL_vals, K_vals};
-    calib_params.printParams();
+    TrackerParams trackerParams;
+    const auto &trackerCfg = toml::find(data, "tracker");
+    trackerParams.removeWindow =
+        toml::find_or<int>(trackerCfg, "remove_window", trackerParams.removeWindow);
+    trackerParams.firstDetectMax =
+        toml::find_or<int>(trackerCfg, "first_detect_max", trackerParams.firstDetectMax);
+    trackerParams.recentWindow =
+        toml::find_or<int>(trackerCfg, "recent_window", trackerParams.recentWindow);
+    trackerParams.recentMinCount =
+        toml::find_or<int>(trackerCfg, "recent_min_count", trackerParams.recentMinCount);
+    trackerParams.totalMinCount =
+        toml::find_or<int>(trackerCfg, "total_min_count", trackerParams.totalMinCount);
+    trackerParams.maxTracks = toml::find_or<int>(trackerCfg, "max_tracks", trackerParams.maxTracks);
+    trackerParams.inferStride =
+        toml::find_or<int>(trackerCfg, "infer_stride", trackerParams.inferStride);
+    trackerParams.schedDistWeight =
+        toml::find_or<float>(trackerCfg, "sched_dist_weight", trackerParams.schedDistWeight);
+    trackerParams.preprocWorkers =
+        toml::find_or<int>(trackerCfg, "preproc_workers", trackerParams.preprocWorkers);
+    trackerParams.featStorage =
+        parseFeatStorage(toml::find_or<std::string>(trackerCfg, "feature_storage", "fp32"));
+    trackerParams.printParams();
+
+    InferBackendParams backendParams;
+    const auto &inferenceCfg = toml::find(data, "inference");
+    backendParams.type =
+        parseInferBackend(toml::find_or<std::string>(inferenceCfg, "backend", "tensorrt"));
+    backendParams.engineDir = toml::find_or<std::string>(inferenceCfg, "engine_dir", "");
+    backendParams.recordDir = toml::find_or<std::string>(inferenceCfg, "record_dir", "");
+    backendParams.replayDir =
+        toml::find_or<std::string>(inferenceCfg, "replay_dir", "Debug/inflog");
+    backendParams.replayMatch =
+        parseReplayMatch(toml::find_or<std::string>(inferenceCfg, "replay_match", "sequence"));
+    backendParams.cpuByteInput = toml::find_or<bool>(inferenceCfg, "cpu_byte_input", false);
+
+    // engine별 시간 model. (GPU 없이 backend = "cpu" / "replay"로 시간까지 흉내 낼 때)
+    const auto &latencyCfg = toml::find(data, "latency");
+    if (toml::find_or<bool>(latencyCfg, "enable", false)) {
+        const std::string wait = toml::find_or<std::string>(latencyCfg, "wait", "sleep");
+        if (wait != "sleep" && wait != "spin") {
+            std::cout << "Invalid latency wait: " << wait << " (sleep, spin)" << std::endl;
+            exit(1);
+        }
+        backendParams.latencySpin = wait == "spin";
+        for (const auto &[engineName, modelCfg] : latencyCfg.as_table()) {
+            if (!modelCfg.is_table()) {
+                continue;
+            }
+            LatencyModel model;
+            model.fixedMs = toml::find_or<double>(modelCfg, "fixed_ms", 0.0);
+            model.perItemMs = toml::find_or<double>(modelCfg, "per_item_ms", 0.0);
+            model.copyGBps = toml::find_or<double>(modelCfg, "copy_gbps", 0.0);
+            backendParams.latencyModels[engineName] = model;
+        }
+    }
+
+    const auto &checkpointCfg = toml::find(data, "checkpoint");
+    const bool bCheckpoint = toml::find_or<bool>(checkpointCfg, "enable", false);
+    const std::string checkpointPath =
+        toml::find_or<std::string>(checkpointCfg, "path", "Debug/tracker.ckpt");
+    const int checkpointInterval = toml::find_or<int>(checkpointCfg, "interval", 30);
+    const double checkpointMaxAge = toml::find_or<double>(checkpointCfg, "max_age_sec", 5.0);
+
+    const auto &occlusionCfg = toml::find(data, "occlusion");
+    const std::string occlusionMethod =
+        toml::find_or<std::string>(occlusionCfg, "method", "bitmask");
+    const bool bSilhouette = toml::find_or<bool>(occlusionCfg, "silhouette", false);
+
+    const auto &debugCfg = toml::find(data, "debug");
+    const bool bAnnotate = toml::find_or<bool>(debugCfg, "annotate", true);
+
+    // Cameras
+    // [[cameras]]가 있으면 camera마다 calib을 읽고, 없으면 [calib]을 "front" camera로 사용.
+    CameraRegistry cameras{occlusionMethod, bSilhouette};
+    auto addCamera = [&cameras](const std::string &name, const toml::value &calibCfg) {
+        const std::array<float, 16> RT_vals = toml::find<std::array<float, 16>>(calibCfg, "RT");
+        const std::array<float, 16> RL_vals = toml::find<std::array<float, 16>>(calibCfg, "RL");
+        const std::array<float, 9> K_vals = toml::find<std::array<float, 9>>(calibCfg, "K");
+
+        const CalibParams calib_params{RT_vals, RL_vals, K_vals};
+        std::cout << "camera " << name << std::endl;
+        calib_params.printParams();
+        cameras.addCamera(name, calib_params);
+    };
+    const auto cameraCfgs =
+        toml::find_or<std::vector<toml::value>>(data, "cameras", std::vector<toml::value>{});
+    if (cameraCfgs.empty()) {
+        addCamera("front", toml::find(data, "calib"));
+    } else {
+        for (const auto &cameraCfg : cameraCfgs) {
+            addCamera(toml::find<std::string>(cameraCfg, "name"), cameraCfg);
+        }
+    }
+    std::cout << "occlusion: " << cameras[0].occMask->name() << std::endl;
+    cameras.setAnnotation(bAnnotate);
 
     // Manager
-    TailRecogManager tailRecogManager;
+    TailRecogManager tailRecogManager{trackerParams, backendParams};
+    if (bCheckpoint) {
+        tailRecogManager.loadCheckpoint(checkpointPath, checkpointMaxAge);
+    }
 
     // Result json
     json jsonResult = json::array();
 
+    std::vector<cv::Mat> imgs(cameras.size());
     int frameIdx = 0;
     for (const auto &eachFrame : j) {
-        std::string imgFilePath = eachFrame["img_file"].get<std::string>();
-        imgFilePath = "/mnt/SATA01/VoSS/20200316-174732(20191213-125018_emul)/" + imgFilePath;
-        std::cout << frameIdx << ": " << imgFilePath << std::endl;
-        cv::Mat img = cv::imread(imgFilePath);
-        cv::Mat displayedImg = img.clone();
+        // camera가 여러 대이면 "img_files": {camera name: path}
+        for (int cameraIdx = 0; cameraIdx < cameras.size(); ++cameraIdx) {
+            std::string imgFilePath =
+                cameras.size() == 1
+                    ? eachFrame["img_file"].get<std::string>()
+                    : eachFrame["img_files"][cameras[cameraIdx].name].get<std::string>();
+            imgFilePath = "/mnt/SATA01/VoSS/20200316-174732(20191213-125018_emul)/" + imgFilePath;
+            std::cout << frameIdx << ": " << imgFilePath << std::endl;
+            imgs[cameraIdx] = cv::imread(imgFilePath);
+        }
 
-        std::vector<Instance> instVec;
+        cameras.clearObjects();
         for (const auto &eachObj : eachFrame["objs"]) {
             // 0    classId in ascending order (car, truck(bus), pedestrian, bicycle(motorcycle))
             // 1    trackingId
@@ -75,22 +173,35 @@ int main(int argc, char **argv) {
             }
 
             // Generate Instance
-            instVec.emplace_back(classId, trackId, xyz, lwh, yaw, calib_params);
+            cameras.addObject(classId, trackId, xyz, lwh, yaw);
         }
 
         // -------------------------
         // Run Manager
         // -------------------------
         chrono::high_resolution_clock::time_point t1 = chrono::high_resolution_clock::now();
-        ArrayXXb occMask = ArrayXXb::Zero(img.rows, img.cols);
+        cameras.project(imgs, tailRecogManager.workerPool());
 
-        std::map<int, cv::Rect> trackId_to_regressedRoi =
-            tailRecogManager.updateDet(img, instVec, occMask);
+        std::map<int, TailRoi> trackId_to_regressedRoi = tailRecogManager.updateDet(imgs, cameras);
         std::map<int, int> trackId_to_state = tailRecogManager.infer();
+        std::map<int, int> trackId_to_age = tailRecogManager.getInferAges();
+        if (bCheckpoint && (frameIdx + 1) % checkpointInterval == 0) {
+            tailRecogManager.saveCheckpoint(checkpointPath);
+        }
         chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
         std::cout << "processing_time (micro sec): " << duration << std::endl;
 
+        const RejectCounts rejectCounts = cameras.rejectCounts();
+        json jsonRejects = json::object();
+        std::cout << "instances:";
+        for (int i = 0; i < kNumRejectReasons; ++i) {
+            const char *reasonName = rejectReasonName(static_cast<RejectReason>(i));
+            jsonRejects[reasonName] = rejectCounts[i];
+            std::cout << " " << reasonName << "=" << rejectCounts[i];
+        }
+        std::cout << std::endl;
+
         // ------------------------
         // Write results to json
         // ------------------------
@@ -99,60 +210,92 @@ int main(int argc, char **argv) {
             jsonInferStates[std::to_string(id)] = state;
         }
 
+        json jsonInferAges = json::object();
+        for (const auto &[id, age] : trackId_to_age) {
+            jsonInferAges[std::to_string(id)] = age;
+        }
+
         json jsonRois = json::object();
-        for (const auto &[id, roi] : trackId_to_regressedRoi) {
+        json jsonRoiCameras = json::object();
+        for (const auto &[id, tailRoi] : trackId_to_regressedRoi) {
             jsonRois[std::to_string(id)] = {
-                roi.x,
-                roi.y,
-                roi.width,
-                roi.height,
+                tailRoi.roi.x,
+                tailRoi.roi.y,
+                tailRoi.roi.width,
+                tailRoi.roi.height,
             };
+            jsonRoiCameras[std::to_string(id)] = cameras[tailRoi.cameraIdx].name;
         }
-        jsonResult.push_back({{"result", jsonInferStates}, {"bbox", jsonRois}});
+        jsonResult.push_back(
+            {{"result", jsonInferStates},
+             {"bbox", jsonRois},
+             {"camera", jsonRoiCameras},
+             {"infer_age", jsonInferAges},
+             {"reject", jsonRejects}});
 
         // -------------------------
-        // Display
+        // Display (camera 마다)
         // -------------------------
-        // Render Boxes
-        for (const auto &inst : instVec) {
-            inst.renderToImg(displayedImg);
-        }
+        for (int cameraIdx = 0; cameraIdx < cameras.size(); ++cameraIdx) {
+            const CameraRegistry::Camera &camera = cameras[cameraIdx];
+            const cv::Mat &img = imgs[cameraIdx];
+            cv::Mat displayedImg = img.clone();
+            // 파일 / 창 이름. camera가 하나면 기존 이름 그대로.
+            const std::string suffix = cameras.size() == 1 ? "" : "_" + camera.name;
 
-        // Mask: eigen -> opencv
-        cv::Mat displayedMask;
-        Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> displayedMaskEigen = occMask;
-        cv::eigen2cv(displayedMaskEigen, displayedMask);
-        displayedMask *= 255;
-        cv::cvtColor(displayedMask, displayedMask, cv::COLOR_GRAY2BGR);
+            // Render Boxes
+            for (int idx = 0; idx < camera.instBatch.size(); ++idx) {
+                if (camera.instBatch.isValidProjection(idx)) {
+                    camera.instBatch[idx].renderToImg(displayedImg);
+                }
+            }
 
-        // Visualize regressedTails to Mask
-        for (const auto &[_, roi] : trackId_to_regressedRoi) {
-            img(roi).copyTo(displayedMask(roi));
-        }
+            // Mask: eigen -> opencv
+            cv::Mat displayedMask;
+            Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> displayedMaskEigen =
+                camera.occMask->toArray();
+            cv::eigen2cv(displayedMaskEigen, displayedMask);
+            displayedMask *= 255;
+            cv::cvtColor(displayedMask, displayedMask, cv::COLOR_GRAY2BGR);
 
-        // Display
-        if (bImWrite) {
-            cv::imwrite("Debug/" + std::to_string(frameIdx) + "img.png", displayedImg);
-            cv::imwrite("Debug/" + std::to_string(frameIdx) + "mask.png", displayedMask);
-        } else {
-            // 0.7초 이전 state이지만 출력.
-            for (const auto &[trackId, state] : trackId_to_state) {
-                std::string state_str = STATES.at(state);
-                cv::Rect roi = trackId_to_regressedRoi[trackId];
-                cv::putText(
-                    displayedMask,
-                    state_str,
-                    {roi.x, roi.y},
-                    cv::FONT_HERSHEY_PLAIN,
-                    1,
-                    {0, 0, 255},
-                    2);
-                std::cout << "drawing " << trackId << std::endl;
+            // Visualize regressedTails to Mask
+            for (const auto &[_, tailRoi] : trackId_to_regressedRoi) {
+                if (tailRoi.cameraIdx == cameraIdx) {
+                    img(tailRoi.roi).copyTo(displayedMask(tailRoi.roi));
+                }
             }
-            cv::imshow("img_display", displayedImg);
-            cv::imshow("mask_display", displayedMask);
-            if (cv::waitKey() == 'q')
-                break;
+
+            // Display
+            if (bImWrite) {
+                cv::imwrite(
+                    "Debug/" + std::to_string(frameIdx) + "img" + suffix + ".png", displayedImg);
+                cv::imwrite(
+                    "Debug/" + std::to_string(frameIdx) + "mask" + suffix + ".png", displayedMask);
+            } else {
+                // 0.7초 이전 state이지만 출력.
+                for (const auto &[trackId, state] : trackId_to_state) {
+                    auto it = trackId_to_regressedRoi.find(trackId);
+                    if (it == trackId_to_regressedRoi.end() || it->second.cameraIdx != cameraIdx) {
+                        continue;
+                    }
+                    std::string state_str = STATES.at(state);
+                    cv::Rect roi = it->second.roi;
+                    cv::putText(
+                        displayedMask,
+                        state_str,
+                        {roi.x, roi.y},
+                        cv::FONT_HERSHEY_PLAIN,
+                        1,
+                        {0, 0, 255},
+                        2);
+                    std::cout << "drawing " << trackId << std::endl;
+                }
+                cv::imshow("img_display" + suffix, displayedImg);
+                cv::imshow("mask_display" + suffix, displayedMask);
+            }
+        }
+        if (!bImWrite && cv::waitKey() == 'q') {
+            break;
         }
 
         frameIdx += 1;
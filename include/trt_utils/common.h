@@ -6,6 +6,9 @@
 
 #include <NvInfer.h>
 
+// TensorRT 8.5부터 uint8 network I/O (DataType::kUINT8) 지원
+#define TRT_UTILS_HAS_UINT8 (NV_TENSORRT_MAJOR * 100 + NV_TENSORRT_MINOR >= 805)
+
 class Logger : public nvinfer1::ILogger {
     void log(nvinfer1::ILogger::Severity severity, const char *msg) override {
         // suppress info-level messages
@@ -39,6 +42,10 @@ inline int getTypeSize(nvinfer1::DataType t) {
     case nvinfer1::DataType::kBOOL:
     case nvinfer1::DataType::kINT8:
         return 1;
+#if TRT_UTILS_HAS_UINT8
+    case nvinfer1::DataType::kUINT8:
+        return 1;
+#endif
     }
     std::cout << "Invalid DataType." << std::endl;
     exit(1);
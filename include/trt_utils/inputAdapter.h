@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./common.h"
+
+/*
+ * raw byte (BGR, NHWC) image를 받는 engine을 위해 network 앞에 변환 layer를 추가한다.
+ * (cast -> channel swap -> (x - mean) * scale)
+ * host는 pixel 당 1 byte만 upload 하고, normalize는 GPU에서 한다.
+ *
+ * TensorRT 8.5 이상은 kUINT8 input을 사용한다. 그 이전 버전은 uint8 binding이 없으므로
+ * kINT8 (dynamic range -127 ~ 127, scale 1)을 사용하고 host가 x - 128을 -127 ~ 127로 잘라 기록한다.
+ * (pixel 0은 1로 전달된다.)
+ * agent는 engine binding의 data type으로 어느 쪽인지 판단한다.
+ */
+namespace InputAdapter {
+
+// output channel 순서 기준, source 값 (0 ~ 255)에 적용. 기본은 RGB (0 ~ 1)
+struct Spec {
+    bool swapRB = true; // BGR -> RGB
+    std::array<float, 3> mean{0.0f, 0.0f, 0.0f};
+    std::array<float, 3> scale{1.0f / 255, 1.0f / 255, 1.0f / 255};
+};
+
+inline bool isByteType(nvinfer1::DataType type) {
+#if TRT_UTILS_HAS_UINT8
+    if (type == nvinfer1::DataType::kUINT8) {
+        return true;
+    }
+#endif
+    return type == nvinfer1::DataType::kINT8;
+}
+
+// 이 TensorRT 버전에서 byte input에 사용할 type
+inline nvinfer1::DataType byteInputType() {
+#if TRT_UTILS_HAS_UINT8
+    return nvinfer1::DataType::kUINT8;
+#else
+    return nvinfer1::DataType::kINT8;
+#endif
+}
+
+// kINT8 input의 dynamic range. TensorRT는 symmetric scale max(|min|, |max|) / 127로
+// dequantize 하므로 저장된 정수 값 그대로 (scale 1) 받으려면 -127 ~ 127이어야 한다.
+constexpr float kInt8RangeMin = -127.0f;
+constexpr float kInt8RangeMax = 127.0f;
+
+// kINT8 input에 TensorRT가 적용하는 dequantize scale
+inline float int8Scale() {
+    return std::max(std::fabs(kInt8RangeMin), std::fabs(kInt8RangeMax)) / 127.0f;
+}
+
+// host에 기록된 byte 값 + offset = 원래 pixel 값 (0 ~ 255)
+inline float byteOffset(nvinfer1::DataType type) {
+    return type == nvinfer1::DataType::kINT8 ? 128.0f : 0.0f;
+}
+
+// prepend()와 emulate()가 같이 사용하는 per-channel 계수. out = x * scale + shift
+inline void channelCoeffs(
+    const Spec &spec,
+    nvinfer1::DataType type,
+    std::array<float, 3> &scale,
+    std::array<float, 3> &shift) {
+    const float offset = byteOffset(type);
+    for (int c = 0; c < 3; ++c) {
+        scale[c] = spec.scale[c];
+        shift[c] = (offset - spec.mean[c]) * spec.scale[c];
+    }
+}
+
+// prepend()의 gather와 emulate()가 같이 사용하는 channel 순서. output channel c = source[order[c]]
+inline std::array<int32_t, 3> channelOrder(const Spec &spec) {
+    return spec.swapRB ? std::array<int32_t, 3>{2, 1, 0} : std::array<int32_t, 3>{0, 1, 2};
+}
+
+// CPU stand-in. prepend()가 추가하는 layer와 같은 연산을 host에서 수행한다.
+// src: numPixels x 3 byte (type), dst: numPixels x 3 float
+inline void
+emulate(const Spec &spec, nvinfer1::DataType type, const void *src, float *dst, size_t numPixels) {
+    std::array<float, 3> scale;
+    std::array<float, 3> shift;
+    channelCoeffs(spec, type, scale, shift);
+    const std::array<int32_t, 3> order = channelOrder(spec);
+
+    const bool isSigned = type == nvinfer1::DataType::kINT8;
+    const float dequantScale = isSigned ? int8Scale() : 1.0f;
+    for (size_t p = 0; p < numPixels; ++p) {
+        for (int c = 0; c < 3; ++c) {
+            const size_t srcIdx = 3 * p + order[c];
+            const float x = isSigned ? static_cast<const int8_t *>(src)[srcIdx]
+                                     : static_cast<const uint8_t *>(src)[srcIdx];
+            dst[3 * p + c] = x * dequantScale * scale[c] + shift[c];
+        }
+    }
+}
+
+// emulate() 결과의 element 하나. idx는 dst의 element index
+inline float emulateAt(const Spec &spec, nvinfer1::DataType type, const void *src, size_t idx) {
+    std::array<float, 3> scale;
+    std::array<float, 3> shift;
+    channelCoeffs(spec, type, scale, shift);
+    const int c = static_cast<int>(idx % 3);
+    const size_t srcIdx = idx - c + channelOrder(spec)[c];
+    const float x = type == nvinfer1::DataType::kINT8
+                        ? static_cast<const int8_t *>(src)[srcIdx] * int8Scale()
+                        : static_cast<const uint8_t *>(src)[srcIdx];
+    return x * scale[c] + shift[c];
+}
+
+// prepend()에 전달된 weight. engine build가 끝날 때까지 유지되어야 한다.
+struct PrefixWeights {
+    std::array<int32_t, 3> gatherIndices;
+    std::array<float, 3> scale;
+    std::array<float, 3> shift;
+};
+
+// network의 float NHWC input (channel 3)을 같은 이름의 byte input으로 교체.
+// builder config는 setBuilderFlags()로 설정한다.
+inline void
+prepend(nvinfer1::INetworkDefinition &network, const Spec &spec, PrefixWeights &weights) {
+    if (network.getNbInputs() != 1) {
+        std::cout << "Input adapter: network must have exactly one input" << std::endl;
+        exit(1);
+    }
+    nvinfer1::ITensor *floatInput = network.getInput(0);
+    const nvinfer1::Dims dims = floatInput->getDimensions();
+    const int channelAxis = dims.nbDims - 1;
+    if (floatInput->getType() != nvinfer1::DataType::kFLOAT || dims.nbDims < 2 ||
+        dims.d[channelAxis] != 3) {
+        std::cout << "Input adapter: expected float NHWC input with 3 channels" << std::endl;
+        exit(1);
+    }
+
+    // 기존 input을 사용하던 layer들. 마지막에 변환 결과로 교체한다.
+    std::vector<std::pair<nvinfer1::ILayer *, int>> consumers;
+    for (int i = 0; i < network.getNbLayers(); ++i) {
+        nvinfer1::ILayer *layer = network.getLayer(i);
+        for (int j = 0; j < layer->getNbInputs(); ++j) {
+            if (layer->getInput(j) == floatInput) {
+                consumers.emplace_back(layer, j);
+            }
+        }
+    }
+
+    const std::string name = floatInput->getName();
+    const nvinfer1::DataType byteType = byteInputType();
+    floatInput->setName((name + "_float").c_str());
+    nvinfer1::ITensor *byteInput = network.addInput(name.c_str(), byteType, dims);
+    if (byteType == nvinfer1::DataType::kINT8) {
+        byteInput->setDynamicRange(kInt8RangeMin, kInt8RangeMax); // scale 1 : 저장된 정수 값 그대로
+    }
+
+    // 1. cast (byte -> float)
+    nvinfer1::IIdentityLayer *cast = network.addIdentity(*byteInput);
+    cast->setOutputType(0, nvinfer1::DataType::kFLOAT);
+    nvinfer1::ITensor *x = cast->getOutput(0);
+
+    // 2. channel swap (마지막 axis gather)
+    if (spec.swapRB) {
+        weights.gatherIndices = channelOrder(spec);
+        nvinfer1::Dims indexDims;
+        indexDims.nbDims = 1;
+        indexDims.d[0] = 3;
+        nvinfer1::IConstantLayer *indices = network.addConstant(
+            indexDims,
+            nvinfer1::Weights{nvinfer1::DataType::kINT32, weights.gatherIndices.data(), 3});
+        x = network.addGather(*x, *indices->getOutput(0), channelAxis)->getOutput(0);
+    }
+
+    // 3. normalize
+    channelCoeffs(spec, byteType, weights.scale, weights.shift);
+    nvinfer1::IScaleLayer *normalize = network.addScaleNd(
+        *x,
+        nvinfer1::ScaleMode::kCHANNEL,
+        nvinfer1::Weights{nvinfer1::DataType::kFLOAT, weights.shift.data(), 3},
+        nvinfer1::Weights{nvinfer1::DataType::kFLOAT, weights.scale.data(), 3},
+        nvinfer1::Weights{nvinfer1::DataType::kFLOAT, nullptr, 0},
+        channelAxis);
+
+    for (auto &[layer, inputIdx] : consumers) {
+        layer->setInput(inputIdx, *normalize->getOutput(0));
+    }
+    network.removeTensor(*floatInput);
+}
+
+// prepend() 된 network의 builder 설정.
+// TensorRT 8.5 미만은 kINT8 input binding에 kINT8 flag가 필요하다. calibrator는 필요 없다.
+// dynamic range를 가진 tensor는 prepend()가 scale 1로 지정한 byte input 뿐이고, range가 없는
+// 나머지 tensor를 쓰는 layer는 INT8 kernel을 선택하지 않으므로 (missing dynamic range 경고 후
+// non-INT8 구현) network의 정밀도는 kFP16 등 다른 flag가 정한 그대로이다.
+inline void setBuilderFlags(nvinfer1::IBuilderConfig &config) {
+    if (byteInputType() == nvinfer1::DataType::kINT8) {
+        config.setFlag(nvinfer1::BuilderFlag::kINT8);
+    }
+}
+
+} // namespace InputAdapter
@@ -0,0 +1,516 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TRT_UTILS_SIMD_X86 1
+#endif
+
+/*
+ * input / output tensor 변환용 vectorized kernel.
+ * (u8 -> f32 scale / offset, HWC <-> CHW, channel swap, f32 <-> f16)
+ *
+ * 실행 중인 CPU를 보고 AVX2 / SSE4.1 / scalar 중 하나를 처음 호출 시 선택한다.
+ * 환경변수 TRT_UTILS_SIMD (avx2, sse41, scalar)로 더 낮은 단계를 강제할 수 있으며,
+ * scalar 구현은 다른 단계의 reference이기도 하다. (결과는 bit 단위로 같다.)
+ * x86이 아니면 scalar만 사용한다.
+ */
+namespace SimdKernels {
+
+enum class Isa { kScalar, kSSE41, kAVX2 };
+
+inline const char *isaName(Isa isa) {
+    switch (isa) {
+    case Isa::kScalar:
+        return "scalar";
+    case Isa::kSSE41:
+        return "sse41";
+    case Isa::kAVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+inline Isa detectIsa() {
+    Isa isa = Isa::kScalar;
+#if defined(TRT_UTILS_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")) {
+        isa = Isa::kAVX2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        isa = Isa::kSSE41;
+    }
+#endif
+
+    const char *env = std::getenv("TRT_UTILS_SIMD");
+    if (env != nullptr) {
+        const std::string name{env};
+        Isa requested = isa;
+        if (name == "scalar") {
+            requested = Isa::kScalar;
+        } else if (name == "sse41") {
+            requested = Isa::kSSE41;
+        } else if (name == "avx2") {
+            requested = Isa::kAVX2;
+        } else {
+            std::cout << "Invalid TRT_UTILS_SIMD: " << name << " (avx2, sse41, scalar)"
+                      << std::endl;
+        }
+        // CPU가 지원하는 단계보다 높게는 설정할 수 없다.
+        if (static_cast<int>(requested) < static_cast<int>(isa)) {
+            isa = requested;
+        }
+    }
+    return isa;
+}
+
+inline Isa activeIsa() {
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+// -------------------------------------------
+// Scalar (reference)
+// -------------------------------------------
+namespace scalar {
+
+// IEEE 754 binary32 -> binary16 (round to nearest even)
+inline uint16_t floatToHalf(float f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000U;
+    x &= 0x7fffffffU;
+
+    if (x >= 0x7f800000U) { // inf, nan (F16C와 같이 quiet nan으로, payload 상위 bit 유지)
+        return sign | (x > 0x7f800000U ? 0x7e00U | ((x >> 13) & 0x3ffU) : 0x7c00U);
+    }
+    if (x >= 0x47800000U) { // overflow -> inf
+        return sign | 0x7c00U;
+    }
+    if (x < 0x38800000U) { // half의 subnormal 영역
+        const uint32_t exp = x >> 23;
+        if (exp < 102) {
+            return sign;
+        }
+        const uint32_t mant = (x & 0x7fffffU) | 0x800000U;
+        const uint32_t shift = 126 - exp;
+        uint32_t h = mant >> shift;
+        const uint32_t rem = mant & ((1U << shift) - 1);
+        const uint32_t halfway = 1U << (shift - 1);
+        if (rem > halfway || (rem == halfway && (h & 1U))) {
+            ++h;
+        }
+        return sign | h;
+    }
+
+    uint32_t h = (x - 0x38000000U) >> 13; // exponent rebias (127 -> 15)
+    const uint32_t rem = x & 0x1fffU;
+    if (rem > 0x1000U || (rem == 0x1000U && (h & 1U))) {
+        ++h; // mantissa carry는 exponent로 자연스럽게 넘어간다. (65520 이상 -> inf)
+    }
+    return sign | h;
+}
+
+inline float halfToFloat(uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000U) << 16;
+    const uint32_t exp = (h >> 10) & 0x1fU;
+    const uint32_t mant = h & 0x3ffU;
+
+    uint32_t x;
+    if (exp == 0) {
+        const float subnormal = std::ldexp(static_cast<float>(mant), -24);
+        return sign ? -subnormal : subnormal;
+    } else if (exp == 31) {
+        x = sign | 0x7f800000U | (mant << 13) | (mant ? 0x400000U : 0U); // nan은 quiet nan으로
+    } else {
+        x = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+inline void u8ToF32(const uint8_t *src, float *dst, size_t n, float scale, float offset) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]) * scale + offset;
+    }
+}
+
+inline void hwcToChw(const float *src, float *dst, size_t numPixels, int channels) {
+    for (size_t p = 0; p < numPixels; ++p) {
+        for (int c = 0; c < channels; ++c) {
+            dst[c * numPixels + p] = src[p * channels + c];
+        }
+    }
+}
+
+inline void chwToHwc(const float *src, float *dst, size_t numPixels, int channels) {
+    for (size_t p = 0; p < numPixels; ++p) {
+        for (int c = 0; c < channels; ++c) {
+            dst[p * channels + c] = src[c * numPixels + p];
+        }
+    }
+}
+
+inline void swapRB(const float *src, float *dst, size_t numPixels) {
+    for (size_t p = 0; p < numPixels; ++p) {
+        const float r = src[3 * p];
+        const float g = src[3 * p + 1];
+        const float b = src[3 * p + 2];
+        dst[3 * p] = b;
+        dst[3 * p + 1] = g;
+        dst[3 * p + 2] = r;
+    }
+}
+
+inline void f32ToF16(const float *src, uint16_t *dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = floatToHalf(src[i]);
+    }
+}
+
+inline void f16ToF32(const uint16_t *src, float *dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = halfToFloat(src[i]);
+    }
+}
+
+} // namespace scalar
+
+#if defined(TRT_UTILS_SIMD_X86)
+// -------------------------------------------
+// SSE4.1 : 4 floats (3 channel이면 4 pixels)
+// -------------------------------------------
+namespace sse41 {
+
+#define TRT_UTILS_SSE41 __attribute__((target("sse4.1")))
+
+// interleaved 4 pixels (a, b, c) <-> channel별 4 values (r, g, b)
+// r는 a의 0, 3 / b의 2 / c의 1 번째에 있으므로 blend 후 한 vector 내에서 shuffle.
+TRT_UTILS_SSE41 inline void
+deinterleave3(__m128 a, __m128 b, __m128 c, __m128 &ch0, __m128 &ch1, __m128 &ch2) {
+    const __m128 t0 = _mm_blend_ps(_mm_blend_ps(a, b, 0b0100), c, 0b0010); // 0 3 2 1
+    const __m128 t1 = _mm_blend_ps(_mm_blend_ps(a, b, 0b1001), c, 0b0100); // 1 0 3 2
+    const __m128 t2 = _mm_blend_ps(_mm_blend_ps(a, b, 0b0010), c, 0b1001); // 2 1 0 3
+    ch0 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1, 2, 3, 0));
+    ch1 = _mm_shuffle_ps(t1, t1, _MM_SHUFFLE(2, 3, 0, 1));
+    ch2 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+// deinterleave3의 역. (shuffle은 자기 자신이 역)
+TRT_UTILS_SSE41 inline void
+interleave3(__m128 ch0, __m128 ch1, __m128 ch2, __m128 &a, __m128 &b, __m128 &c) {
+    const __m128 t0 = _mm_shuffle_ps(ch0, ch0, _MM_SHUFFLE(1, 2, 3, 0));
+    const __m128 t1 = _mm_shuffle_ps(ch1, ch1, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m128 t2 = _mm_shuffle_ps(ch2, ch2, _MM_SHUFFLE(3, 0, 1, 2));
+    a = _mm_blend_ps(_mm_blend_ps(t0, t1, 0b0010), t2, 0b0100);
+    b = _mm_blend_ps(_mm_blend_ps(t0, t1, 0b1001), t2, 0b0010);
+    c = _mm_blend_ps(_mm_blend_ps(t0, t1, 0b0100), t2, 0b1001);
+}
+
+TRT_UTILS_SSE41 inline void
+u8ToF32(const uint8_t *src, float *dst, size_t n, float scale, float offset) {
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 vOffset = _mm_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t packed;
+        std::memcpy(&packed, src + i, sizeof(packed));
+        const __m128 x = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(x, vScale), vOffset));
+    }
+    scalar::u8ToF32(src + i, dst + i, n - i, scale, offset);
+}
+
+TRT_UTILS_SSE41 inline void
+hwcToChw(const float *src, float *dst, size_t numPixels, int channels) {
+    if (channels != 3) {
+        scalar::hwcToChw(src, dst, numPixels, channels);
+        return;
+    }
+    size_t p = 0;
+    for (; p + 4 <= numPixels; p += 4) {
+        __m128 ch0, ch1, ch2;
+        const float *s = src + 3 * p;
+        deinterleave3(_mm_loadu_ps(s), _mm_loadu_ps(s + 4), _mm_loadu_ps(s + 8), ch0, ch1, ch2);
+        _mm_storeu_ps(dst + p, ch0);
+        _mm_storeu_ps(dst + numPixels + p, ch1);
+        _mm_storeu_ps(dst + 2 * numPixels + p, ch2);
+    }
+    for (; p < numPixels; ++p) {
+        for (int c = 0; c < 3; ++c) {
+            dst[c * numPixels + p] = src[p * 3 + c];
+        }
+    }
+}
+
+TRT_UTILS_SSE41 inline void
+chwToHwc(const float *src, float *dst, size_t numPixels, int channels) {
+    if (channels != 3) {
+        scalar::chwToHwc(src, dst, numPixels, channels);
+        return;
+    }
+    size_t p = 0;
+    for (; p + 4 <= numPixels; p += 4) {
+        __m128 a, b, c;
+        interleave3(
+            _mm_loadu_ps(src + p),
+            _mm_loadu_ps(src + numPixels + p),
+            _mm_loadu_ps(src + 2 * numPixels + p),
+            a,
+            b,
+            c);
+        float *d = dst + 3 * p;
+        _mm_storeu_ps(d, a);
+        _mm_storeu_ps(d + 4, b);
+        _mm_storeu_ps(d + 8, c);
+    }
+    for (; p < numPixels; ++p) {
+        for (int c = 0; c < 3; ++c) {
+            dst[p * 3 + c] = src[c * numPixels + p];
+        }
+    }
+}
+
+TRT_UTILS_SSE41 inline void swapRB(const float *src, float *dst, size_t numPixels) {
+    size_t p = 0;
+    for (; p + 4 <= numPixels; p += 4) {
+        __m128 ch0, ch1, ch2, a, b, c;
+        const float *s = src + 3 * p;
+        deinterleave3(_mm_loadu_ps(s), _mm_loadu_ps(s + 4), _mm_loadu_ps(s + 8), ch0, ch1, ch2);
+        interleave3(ch2, ch1, ch0, a, b, c);
+        float *d = dst + 3 * p;
+        _mm_storeu_ps(d, a);
+        _mm_storeu_ps(d + 4, b);
+        _mm_storeu_ps(d + 8, c);
+    }
+    scalar::swapRB(src + 3 * p, dst + 3 * p, numPixels - p);
+}
+
+#undef TRT_UTILS_SSE41
+
+} // namespace sse41
+
+// -------------------------------------------
+// AVX2 (+F16C) : 8 floats (3 channel이면 8 pixels)
+// -------------------------------------------
+namespace avx2 {
+
+#define TRT_UTILS_AVX2 __attribute__((target("avx2,f16c")))
+
+// sse41::deinterleave3과 같은 방식. channel k의 원소는 a, b, c의 서로 다른 위치에 있다.
+TRT_UTILS_AVX2 inline void
+deinterleave3(__m256 a, __m256 b, __m256 c, __m256 &ch0, __m256 &ch1, __m256 &ch2) {
+    const __m256 t0 = _mm256_blend_ps(_mm256_blend_ps(a, b, 0b10010010), c, 0b00100100);
+    const __m256 t1 = _mm256_blend_ps(_mm256_blend_ps(a, b, 0b00100100), c, 0b01001001);
+    const __m256 t2 = _mm256_blend_ps(_mm256_blend_ps(a, b, 0b01001001), c, 0b10010010);
+    ch0 = _mm256_permutevar8x32_ps(t0, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+    ch1 = _mm256_permutevar8x32_ps(t1, _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+    ch2 = _mm256_permutevar8x32_ps(t2, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+}
+
+TRT_UTILS_AVX2 inline void
+interleave3(__m256 ch0, __m256 ch1, __m256 ch2, __m256 &a, __m256 &b, __m256 &c) {
+    const __m256 t0 = _mm256_permutevar8x32_ps(ch0, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+    const __m256 t1 = _mm256_permutevar8x32_ps(ch1, _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+    const __m256 t2 = _mm256_permutevar8x32_ps(ch2, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+    a = _mm256_blend_ps(_mm256_blend_ps(t0, t1, 0b10010010), t2, 0b00100100);
+    b = _mm256_blend_ps(_mm256_blend_ps(t0, t1, 0b00100100), t2, 0b01001001);
+    c = _mm256_blend_ps(_mm256_blend_ps(t0, t1, 0b01001001), t2, 0b10010010);
+}
+
+TRT_UTILS_AVX2 inline void
+u8ToF32(const uint8_t *src, float *dst, size_t n, float scale, float offset) {
+    const __m256 vScale = _mm256_set1_ps(scale);
+    const __m256 vOffset = _mm256_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i));
+        const __m256 x = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        // scalar와 같은 결과가 되도록 fma를 쓰지 않는다.
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(x, vScale), vOffset));
+    }
+    scalar::u8ToF32(src + i, dst + i, n - i, scale, offset);
+}
+
+TRT_UTILS_AVX2 inline void
+hwcToChw(const float *src, float *dst, size_t numPixels, int channels) {
+    if (channels != 3) {
+        scalar::hwcToChw(src, dst, numPixels, channels);
+        return;
+    }
+    size_t p = 0;
+    for (; p + 8 <= numPixels; p += 8) {
+        __m256 ch0, ch1, ch2;
+        const float *s = src + 3 * p;
+        deinterleave3(
+            _mm256_loadu_ps(s), _mm256_loadu_ps(s + 8), _mm256_loadu_ps(s + 16), ch0, ch1, ch2);
+        _mm256_storeu_ps(dst + p, ch0);
+        _mm256_storeu_ps(dst + numPixels + p, ch1);
+        _mm256_storeu_ps(dst + 2 * numPixels + p, ch2);
+    }
+    for (; p < numPixels; ++p) {
+        for (int c = 0; c < 3; ++c) {
+            dst[c * numPixels + p] = src[p * 3 + c];
+        }
+    }
+}
+
+TRT_UTILS_AVX2 inline void
+chwToHwc(const float *src, float *dst, size_t numPixels, int channels) {
+    if (channels != 3) {
+        scalar::chwToHwc(src, dst, numPixels, channels);
+        return;
+    }
+    size_t p = 0;
+    for (; p + 8 <= numPixels; p += 8) {
+        __m256 a, b, c;
+        interleave3(
+            _mm256_loadu_ps(src + p),
+            _mm256_loadu_ps(src + numPixels + p),
+            _mm256_loadu_ps(src + 2 * numPixels + p),
+            a,
+            b,
+            c);
+        float *d = dst + 3 * p;
+        _mm256_storeu_ps(d, a);
+        _mm256_storeu_ps(d + 8, b);
+        _mm256_storeu_ps(d + 16, c);
+    }
+    for (; p < numPixels; ++p) {
+        for (int c = 0; c < 3; ++c) {
+            dst[p * 3 + c] = src[c * numPixels + p];
+        }
+    }
+}
+
+TRT_UTILS_AVX2 inline void swapRB(const float *src, float *dst, size_t numPixels) {
+    size_t p = 0;
+    for (; p + 8 <= numPixels; p += 8) {
+        __m256 ch0, ch1, ch2, a, b, c;
+        const float *s = src + 3 * p;
+        deinterleave3(
+            _mm256_loadu_ps(s), _mm256_loadu_ps(s + 8), _mm256_loadu_ps(s + 16), ch0, ch1, ch2);
+        interleave3(ch2, ch1, ch0, a, b, c);
+        float *d = dst + 3 * p;
+        _mm256_storeu_ps(d, a);
+        _mm256_storeu_ps(d + 8, b);
+        _mm256_storeu_ps(d + 16, c);
+    }
+    scalar::swapRB(src + 3 * p, dst + 3 * p, numPixels - p);
+}
+
+TRT_UTILS_AVX2 inline void f32ToF16(const float *src, uint16_t *dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+    }
+    scalar::f32ToF16(src + i, dst + i, n - i);
+}
+
+TRT_UTILS_AVX2 inline void f16ToF32(const uint16_t *src, float *dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    scalar::f16ToF32(src + i, dst + i, n - i);
+}
+
+#undef TRT_UTILS_AVX2
+
+} // namespace avx2
+#endif
+
+// -------------------------------------------
+// Dispatch
+// -------------------------------------------
+
+// dst[i] = src[i] * scale + offset
+inline void u8ToF32(const uint8_t *src, float *dst, size_t n, float scale, float offset) {
+#if defined(TRT_UTILS_SIMD_X86)
+    switch (activeIsa()) {
+    case Isa::kAVX2:
+        return avx2::u8ToF32(src, dst, n, scale, offset);
+    case Isa::kSSE41:
+        return sse41::u8ToF32(src, dst, n, scale, offset);
+    case Isa::kScalar:
+        break;
+    }
+#endif
+    scalar::u8ToF32(src, dst, n, scale, offset);
+}
+
+// interleaved (numPixels x channels) -> planar (channels x numPixels). SIMD는 3 channel만.
+inline void hwcToChw(const float *src, float *dst, size_t numPixels, int channels) {
+#if defined(TRT_UTILS_SIMD_X86)
+    switch (activeIsa()) {
+    case Isa::kAVX2:
+        return avx2::hwcToChw(src, dst, numPixels, channels);
+    case Isa::kSSE41:
+        return sse41::hwcToChw(src, dst, numPixels, channels);
+    case Isa::kScalar:
+        break;
+    }
+#endif
+    scalar::hwcToChw(src, dst, numPixels, channels);
+}
+
+// planar (channels x numPixels) -> interleaved (numPixels x channels). SIMD는 3 channel만.
+inline void chwToHwc(const float *src, float *dst, size_t numPixels, int channels) {
+#if defined(TRT_UTILS_SIMD_X86)
+    switch (activeIsa()) {
+    case Isa::kAVX2:
+        return avx2::chwToHwc(src, dst, numPixels, channels);
+    case Isa::kSSE41:
+        return sse41::chwToHwc(src, dst, numPixels, channels);
+    case Isa::kScalar:
+        break;
+    }
+#endif
+    scalar::chwToHwc(src, dst, numPixels, channels);
+}
+
+// interleaved 3 channel의 0번과 2번 channel 교환 (BGR <-> RGB). src == dst 가능.
+inline void swapRB(const float *src, float *dst, size_t numPixels) {
+#if defined(TRT_UTILS_SIMD_X86)
+    switch (activeIsa()) {
+    case Isa::kAVX2:
+        return avx2::swapRB(src, dst, numPixels);
+    case Isa::kSSE41:
+        return sse41::swapRB(src, dst, numPixels);
+    case Isa::kScalar:
+        break;
+    }
+#endif
+    scalar::swapRB(src, dst, numPixels);
+}
+
+// f32 -> f16 (round to nearest even). SSE4.1 단계에서는 scalar.
+inline void f32ToF16(const float *src, uint16_t *dst, size_t n) {
+#if defined(TRT_UTILS_SIMD_X86)
+    if (activeIsa() == Isa::kAVX2) {
+        return avx2::f32ToF16(src, dst, n);
+    }
+#endif
+    scalar::f32ToF16(src, dst, n);
+}
+
+inline void f16ToF32(const uint16_t *src, float *dst, size_t n) {
+#if defined(TRT_UTILS_SIMD_X86)
+    if (activeIsa() == Isa::kAVX2) {
+        return avx2::f16ToF32(src, dst, n);
+    }
+#endif
+    scalar::f16ToF32(src, dst, n);
+}
+
+} // namespace SimdKernels
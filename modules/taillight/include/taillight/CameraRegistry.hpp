@@ -0,0 +1,69 @@
+#pragma once
+#include "InstanceBatch.hpp"
+#include "OcclusionMap.hpp"
+#include "WorkerPool.hpp"
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+/*
+ * 이름이 붙은 camera들의 calibration과 camera별 projection / occlusion state.
+ * 한 프레임의 object 목록을 모든 camera에 (camera 마다 병렬로) projection 하고,
+ * object마다 tail이 가장 잘 보이는 camera 하나를 골라 그 camera에서만 tail을 인식한다.
+ * (다른 camera에서도 occluder로는 사용된다.)
+ */
+class CameraRegistry {
+  public:
+    struct Camera {
+        Camera(
+            const std::string &name,
+            const CalibParams &calib,
+            std::unique_ptr<OcclusionMap> occMask)
+            : name(name), calib(calib), occMask(std::move(occMask)) {}
+
+        std::string name;
+        CalibParams calib;
+        InstanceBatch instBatch;               // 이 camera에 projection 된 object들
+        std::unique_ptr<OcclusionMap> occMask; // 이 camera의 occlusion state
+        std::vector<char> routed; // instBatch index별, 이 camera가 tail을 담당하는지
+    };
+
+    // silhouette이면 occluder와 tail을 bounding rect 대신 projection의 convex hull로 다룬다.
+    // hull의 scanline마다 사각형이 하나씩 생기므로 rect_union과는 함께 사용할 수 없다. (종료)
+    CameraRegistry(const std::string &occlusionMethod, bool silhouette = false);
+
+    // 추가된 camera의 index. 이름이 중복되면 종료.
+    int addCamera(const std::string &name, const CalibParams &calib);
+    int find(const std::string &name) const; // 없으면 -1
+
+    int size() const { return static_cast<int>(mCameras.size()); }
+    bool isSilhouette() const { return mSilhouette; }
+    Camera &operator[](int cameraIdx) { return mCameras[cameraIdx]; }
+    const Camera &operator[](int cameraIdx) const { return mCameras[cameraIdx]; }
+
+    // 프레임의 object 목록. 모든 camera에 같은 index로 추가된다.
+    void clearObjects();
+    void addObject(
+        int classId,
+        int trackId,
+        const std::array<float, 3> &xyz,
+        const std::array<float, 3> &lwh,
+        float yaw);
+
+    // 모든 camera의 debug annotation on / off
+    void setAnnotation(bool enable);
+    // 이번 프레임 모든 camera의 rejection reason별 instance 수
+    RejectCounts rejectCounts() const;
+
+    // imgs[cameraIdx] 크기로 모든 camera에 병렬 projection, occlusion reset 후 routing.
+    // camera 별 projection은 workers (TailRecogManager::workerPool())에서 실행한다.
+    void project(const std::vector<cv::Mat> &imgs, WorkerPool &workers);
+
+  private:
+    void route();
+
+    std::string mOcclusionMethod;
+    bool mSilhouette;
+    std::vector<Camera> mCameras;
+};
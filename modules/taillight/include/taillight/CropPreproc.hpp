@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <opencv2/opencv.hpp>
+
+#include "trt_utils/inputAdapter.h"
+
+/*
+ * tail crop preprocessing을 한 번의 pass로 수행.
+ * (crop -> bilinear resize -> BGR / RGB swap -> (x - mean) * scale -> float tensor)
+ * 중간 cv::Mat 없이 source ROI를 직접 sampling 하여 agent input buffer의 batch slot에 쓴다.
+ * sampling 위치는 cv::resize(INTER_LINEAR)와 같은 pixel center 정렬을 따른다.
+ * engine이 byte input을 받으면 (trt_utils/inputAdapter.h) 반올림 한 pixel 값만 쓰고
+ * normalize는 network에서 한다.
+ */
+namespace CropPreproc {
+
+enum class Layout {
+    kNHWC,
+    kNCHW,
+};
+
+enum class OutType {
+    kFloat32, // (x - mean) * scale
+    kUInt8,   // 반올림 한 pixel 값. mean / scale 미적용
+    kInt8,    // 반올림 한 pixel 값 - 128 (-127 ~ 127). (TensorRT 8.5 미만의 byte input)
+};
+
+struct Params {
+    int outH;
+    int outW;
+    Layout layout = Layout::kNHWC;
+    OutType outType = OutType::kFloat32;
+    bool swapRB = true; // BGR -> RGB
+    // output channel 순서 기준, source 값 (0 ~ 255)에 적용. 기본은 (0 ~ 1) normalize.
+    // ex) deprecated path의 (x / 255 - 0.5) * 4 : mean 127.5, scale 4 / 255
+    std::array<float, 3> mean{0.0f, 0.0f, 0.0f};
+    std::array<float, 3> scale{1.0f / 255, 1.0f / 255, 1.0f / 255};
+
+    int numEl() const { return outH * outW * 3; }
+    int elemSize() const { return outType == OutType::kFloat32 ? sizeof(float) : 1; }
+};
+
+// img (CV_8UC3)의 roi를 params 대로 dst (params.numEl()개, outType)에 기록.
+// roi는 image 범위로 clipping 되며, 비어 있으면 dst를 0으로 채운다.
+void cropResize(const cv::Mat &img, const cv::Rect &roi, const Params &params, void *dst);
+
+// engine input binding type (float / byte)에 맞는 설정.
+// byte input engine은 spec의 channel swap / normalize를 network 앞단에서 수행한다.
+Params
+paramsFor(int outH, int outW, nvinfer1::DataType inputType, const InputAdapter::Spec &spec);
+
+} // namespace CropPreproc
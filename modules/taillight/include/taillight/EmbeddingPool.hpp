@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "./FeatureCodec.hpp"
+
+/*
+ * UNet embedding (frame feature)들을 저장하는 reference counted slot pool.
+ * track의 feature window는 slot index만 가지므로, 반복 / back-fill 되는 frame은
+ * 같은 slot을 가리키고 feature 복사는 CNN3D input을 만들 때 한 번만 일어난다.
+ * slot은 chunk 단위로 할당되며, 한 번 할당된 chunk는 재사용된다.
+ * maxSlots > 0 이면 모든 chunk를 생성 시에 미리 할당하고 더 이상 늘리지 않는다. (memory 상한)
+ */
+class EmbeddingPool {
+  public:
+    static constexpr int kZeroSlot = -1; // 모든 값이 0인 frame. (ref count 없음)
+    static constexpr size_t kAlignment = 64;
+
+    EmbeddingPool(
+        int frameSize,
+        FeatStorage storage = FeatStorage::kFP32,
+        int slotsPerChunk = 64,
+        int maxSlots = 0)
+        : mFrameSize(frameSize), mStorage(storage), mSlotsPerChunk(slotsPerChunk),
+          mMaxSlots(maxSlots) {
+        // slot 시작 주소가 alignment를 유지하도록 frame stride를 올림.
+        mFrameBytes = static_cast<size_t>(frameSize) * featElemSize(storage);
+        mFrameBytes = (mFrameBytes + kAlignment - 1) / kAlignment * kAlignment;
+
+        // 고정 용량이면 warm-up 없이 전부 미리 할당.
+        while (static_cast<int>(mRefCounts.size()) < mMaxSlots) {
+            addChunk();
+        }
+    }
+
+    EmbeddingPool(const EmbeddingPool &) = delete;
+    EmbeddingPool &operator=(const EmbeddingPool &) = delete;
+
+    // src (frameSize floats)를 encode하여 새 slot에 저장. 반환된 slot의 ref count는 1.
+    int store(const float *src) {
+        const int slot = acquire();
+        mScales[slot] = FeatCodec::encode(mStorage, src, data(slot), mFrameSize);
+        return slot;
+    }
+
+    // 이미 storage 형식으로 encode 된 frame (encodedBytes())을 그대로 저장. (checkpoint 복원용)
+    int storeEncoded(const void *src, float scale) {
+        const int slot = acquire();
+        std::memcpy(data(slot), src, encodedBytes());
+        mScales[slot] = scale;
+        return slot;
+    }
+
+    void retain(int slot) {
+        if (slot != kZeroSlot) {
+            ++mRefCounts[slot];
+        }
+    }
+
+    void release(int slot) {
+        if (slot == kZeroSlot) {
+            return;
+        }
+        if (mRefCounts[slot] <= 0) {
+            std::cout << "EmbeddingPool: release of free slot " << slot << std::endl;
+            exit(1);
+        }
+        if (--mRefCounts[slot] == 0) {
+            mFreeSlots.push_back(slot);
+        }
+    }
+
+    // slot을 FP32로 복원하여 dst (frameSize floats)에 써넣는다.
+    void decode(int slot, float *dst) const {
+        if (slot == kZeroSlot) {
+            std::memset(dst, 0, static_cast<size_t>(mFrameSize) * sizeof(float));
+            return;
+        }
+        FeatCodec::decode(mStorage, data(slot), mScales[slot], dst, mFrameSize);
+    }
+
+    // slot의 encode 된 data. slot을 retain 하고 있는 동안은 내용과 주소가 바뀌지 않는다.
+    const uint8_t *encodedData(int slot) const { return data(slot); }
+    float scale(int slot) const { return mScales[slot]; }
+    size_t encodedBytes() const {
+        return static_cast<size_t>(mFrameSize) * featElemSize(mStorage);
+    }
+
+    int frameSize() const { return mFrameSize; }
+    FeatStorage storage() const { return mStorage; }
+    size_t numSlots() const { return mRefCounts.size(); }
+    size_t numUsedSlots() const { return mRefCounts.size() - mFreeSlots.size(); }
+    size_t numFreeSlots() const { return mFreeSlots.size(); }
+    bool isBounded() const { return mMaxSlots > 0; }
+    size_t nbBytes() const { return mChunks.size() * mSlotsPerChunk * mFrameBytes; }
+
+  private:
+    struct FreeDeleter {
+        void operator()(uint8_t *ptr) const { std::free(ptr); }
+    };
+
+    int acquire() {
+        if (mFreeSlots.empty()) {
+            if (isBounded()) {
+                std::cout << "EmbeddingPool: out of slots (" << mMaxSlots << ")" << std::endl;
+                exit(1);
+            }
+            addChunk();
+        }
+        const int slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        mRefCounts[slot] = 1;
+        return slot;
+    }
+
+    void addChunk() {
+        const size_t nbBytes = static_cast<size_t>(mSlotsPerChunk) * mFrameBytes;
+        mChunks.emplace_back(static_cast<uint8_t *>(std::aligned_alloc(kAlignment, nbBytes)));
+        if (!mChunks.back()) {
+            std::cout << "EmbeddingPool allocation failed" << std::endl;
+            exit(1);
+        }
+
+        const int firstSlot = static_cast<int>(mRefCounts.size());
+        mRefCounts.resize(firstSlot + mSlotsPerChunk, 0);
+        mScales.resize(firstSlot + mSlotsPerChunk, 1.0f);
+        // 낮은 index부터 사용되도록 역순으로 push.
+        for (int slot = firstSlot + mSlotsPerChunk - 1; slot >= firstSlot; --slot) {
+            mFreeSlots.push_back(slot);
+        }
+    }
+
+    uint8_t *data(int slot) {
+        return mChunks[slot / mSlotsPerChunk].get() + (slot % mSlotsPerChunk) * mFrameBytes;
+    }
+    const uint8_t *data(int slot) const {
+        return mChunks[slot / mSlotsPerChunk].get() + (slot % mSlotsPerChunk) * mFrameBytes;
+    }
+
+    int mFrameSize;
+    FeatStorage mStorage;
+    int mSlotsPerChunk;
+    int mMaxSlots; // 0이면 필요할 때마다 chunk 추가
+    size_t mFrameBytes;
+
+    std::vector<std::unique_ptr<uint8_t[], FreeDeleter>> mChunks;
+    std::vector<int> mRefCounts;
+    std::vector<float> mScales; // INT8 dequantize용 slot별 scale
+    std::vector<int> mFreeSlots;
+};
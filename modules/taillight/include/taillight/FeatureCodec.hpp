@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "trt_utils/simdKernels.h"
+
+/*
+ * Tracker에 저장되는 UNet feature의 저장 형식.
+ * FP16 / INT8은 메모리와 bandwidth를 줄이는 대신 약간의 정밀도 손실이 있다.
+ * INT8은 frame마다 하나의 scale (maxAbs / 127)을 가진다.
+ */
+enum class FeatStorage { kFP32, kFP16, kINT8 };
+
+inline FeatStorage parseFeatStorage(const std::string &name) {
+    if (name == "fp32") {
+        return FeatStorage::kFP32;
+    } else if (name == "fp16") {
+        return FeatStorage::kFP16;
+    } else if (name == "int8") {
+        return FeatStorage::kINT8;
+    }
+    std::cout << "Invalid feature storage: " << name << " (fp32, fp16, int8)" << std::endl;
+    exit(1);
+}
+
+inline const char *featStorageName(FeatStorage storage) {
+    switch (storage) {
+    case FeatStorage::kFP32:
+        return "fp32";
+    case FeatStorage::kFP16:
+        return "fp16";
+    case FeatStorage::kINT8:
+        return "int8";
+    }
+    return "unknown";
+}
+
+inline size_t featElemSize(FeatStorage storage) {
+    switch (storage) {
+    case FeatStorage::kFP32:
+        return sizeof(float);
+    case FeatStorage::kFP16:
+        return sizeof(uint16_t);
+    case FeatStorage::kINT8:
+        return sizeof(int8_t);
+    }
+    return sizeof(float);
+}
+
+namespace FeatCodec {
+
+// symmetric per-frame quantization. 반환값은 dequantize에 쓰일 scale.
+inline float encodeInt8(const float *src, int8_t *dst, size_t n) {
+    float maxAbs = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        maxAbs = std::max(maxAbs, std::abs(src[i]));
+    }
+    if (maxAbs == 0.0f) {
+        std::fill(dst, dst + n, 0);
+        return 0.0f;
+    }
+
+    const float scale = maxAbs / 127.0f;
+    const float invScale = 127.0f / maxAbs;
+    for (size_t i = 0; i < n; ++i) {
+        const float q = std::nearbyint(src[i] * invScale);
+        dst[i] = static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+    }
+    return scale;
+}
+
+inline void decodeInt8(const int8_t *src, float scale, float *dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]) * scale;
+    }
+}
+
+// src (n floats)를 storage 형식으로 dst에 encode. 반환값은 frame scale (INT8 외에는 1).
+inline float encode(FeatStorage storage, const float *src, void *dst, size_t n) {
+    switch (storage) {
+    case FeatStorage::kFP32:
+        std::memcpy(dst, src, n * sizeof(float));
+        return 1.0f;
+    case FeatStorage::kFP16:
+        SimdKernels::f32ToF16(src, static_cast<uint16_t *>(dst), n);
+        return 1.0f;
+    case FeatStorage::kINT8:
+        return encodeInt8(src, static_cast<int8_t *>(dst), n);
+    }
+    return 1.0f;
+}
+
+inline void decode(FeatStorage storage, const void *src, float scale, float *dst, size_t n) {
+    switch (storage) {
+    case FeatStorage::kFP32:
+        std::memcpy(dst, src, n * sizeof(float));
+        return;
+    case FeatStorage::kFP16:
+        SimdKernels::f16ToF32(static_cast<const uint16_t *>(src), dst, n);
+        return;
+    case FeatStorage::kINT8:
+        decodeInt8(static_cast<const int8_t *>(src), scale, dst, n);
+        return;
+    }
+}
+
+// FP32 대비 encode -> decode 왕복 오차. (tests/featureCodec_test.cpp)
+struct CodecError {
+    float maxAbsErr{0.0f};
+    float rmsErr{0.0f};
+    float maxAbsRef{0.0f};
+};
+
+inline CodecError measureError(FeatStorage storage, const float *src, size_t n) {
+    std::unique_ptr<uint8_t[]> encoded(new uint8_t[n * featElemSize(storage)]);
+    std::unique_ptr<float[]> decoded(new float[n]);
+    const float scale = encode(storage, src, encoded.get(), n);
+    decode(storage, encoded.get(), scale, decoded.get(), n);
+
+    CodecError err;
+    double sqSum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const float diff = std::abs(decoded[i] - src[i]);
+        err.maxAbsErr = std::max(err.maxAbsErr, diff);
+        err.maxAbsRef = std::max(err.maxAbsRef, std::abs(src[i]));
+        sqSum += static_cast<double>(diff) * diff;
+    }
+    err.rmsErr = n > 0 ? static_cast<float>(std::sqrt(sqSum / n)) : 0.0f;
+    return err;
+}
+
+} // namespace FeatCodec
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+
+#include "./EmbeddingPool.hpp"
+
+/*
+ * 고정 길이 sequence의 frame feature window.
+ * 각 frame은 EmbeddingPool의 slot을 참조하므로, 반복되는 frame은 slot을 공유한다.
+ * push 할 때 가장 오래된 frame의 참조를 해제하고 그 자리를 재사용한다.
+ * slot 참조는 고정 크기 array이므로 track 생성 시에도 heap allocation이 없다.
+ */
+template <int LenSeq> class FeatureRing {
+  public:
+    explicit FeatureRing(EmbeddingPool &pool) : mPool(&pool) {
+        mSlots.fill(EmbeddingPool::kZeroSlot);
+    }
+
+    FeatureRing(const FeatureRing &) = delete;
+    FeatureRing &operator=(const FeatureRing &) = delete;
+
+    FeatureRing(FeatureRing &&other) noexcept
+        : mPool(other.mPool), mSlots(other.mSlots), mHead(other.mHead) {
+        other.mSlots.fill(EmbeddingPool::kZeroSlot);
+    }
+
+    FeatureRing &operator=(FeatureRing &&other) noexcept {
+        if (this != &other) {
+            releaseAll();
+            mPool = other.mPool;
+            mSlots = other.mSlots;
+            mHead = other.mHead;
+            other.mSlots.fill(EmbeddingPool::kZeroSlot);
+        }
+        return *this;
+    }
+
+    ~FeatureRing() { releaseAll(); }
+
+    // head를 한 칸 전진시키고 (이전 oldest 참조 해제), newest가 slot을 참조하도록 한다.
+    void push(int slot) {
+        mPool->retain(slot); // slot이 evict 되는 oldest와 같은 경우를 위해 먼저 retain.
+        advance();
+        mSlots[mHead] = slot;
+    }
+
+    // 직전 newest frame을 그대로 반복. (같은 slot 참조)
+    void pushRepeat() { push(mSlots[mHead]); }
+
+    void pushZero() { push(EmbeddingPool::kZeroSlot); }
+
+    // newest frame이 slot을 참조하도록 바꾼다.
+    void assignBack(int slot) {
+        mPool->retain(slot);
+        mPool->release(mSlots[mHead]);
+        mSlots[mHead] = slot;
+    }
+
+    // 시간 순서 (oldest -> newest)로 dst (lenSeq * frameSize floats)에 FP32로 써넣는다.
+    void writeWindow(float *dst) const {
+        const size_t frameSize = mPool->frameSize();
+        for (int t = 0; t < LenSeq; ++t) {
+            mPool->decode(slotAt(t), dst + t * frameSize);
+        }
+    }
+
+    // t = 0: oldest, t = lenSeq - 1: newest
+    int slotAt(int t) const { return mSlots[(mHead + 1 + t) % LenSeq]; }
+
+    static constexpr int lenSeq() { return LenSeq; }
+
+  private:
+    void advance() {
+        mHead = (mHead + 1) % LenSeq;
+        mPool->release(mSlots[mHead]);
+        mSlots[mHead] = EmbeddingPool::kZeroSlot;
+    }
+
+    void releaseAll() {
+        for (const int slot : mSlots) {
+            mPool->release(slot);
+        }
+        mSlots.fill(EmbeddingPool::kZeroSlot);
+    }
+
+    EmbeddingPool *mPool;
+    std::array<int, LenSeq> mSlots; // frame별 pool slot
+    int mHead{0};                   // newest frame의 index
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/*
+ * int key (trackId) -> int value (index)의 open addressing hash map.
+ * linear probing + backward shift deletion이므로 tombstone이 없고,
+ * capacity 안에서는 insert / erase 시 allocation이 없다.
+ */
+class FlatIdMap {
+  public:
+    static constexpr int kEmpty = std::numeric_limits<int>::min();
+    static constexpr int kNotFound = -1;
+
+    explicit FlatIdMap(size_t capacity = 64) { rehash(roundUpPow2(capacity * 2)); }
+
+    int find(int key) const {
+        for (size_t i = bucketOf(key);; i = (i + 1) & mMask) {
+            if (mKeys[i] == key) {
+                return mValues[i];
+            }
+            if (mKeys[i] == kEmpty) {
+                return kNotFound;
+            }
+        }
+    }
+
+    // 이미 key가 있으면 value를 덮어쓴다.
+    void insert(int key, int value) {
+        if (key == kEmpty) {
+            std::cout << "FlatIdMap: invalid key" << std::endl;
+            exit(1);
+        }
+        // load factor 0.5 이하 유지
+        if ((mSize + 1) * 2 > mKeys.size()) {
+            rehash(mKeys.size() * 2);
+        }
+
+        size_t i = bucketOf(key);
+        for (; mKeys[i] != kEmpty; i = (i + 1) & mMask) {
+            if (mKeys[i] == key) {
+                mValues[i] = value;
+                return;
+            }
+        }
+        mKeys[i] = key;
+        mValues[i] = value;
+        ++mSize;
+    }
+
+    bool erase(int key) {
+        size_t i = bucketOf(key);
+        for (; mKeys[i] != key; i = (i + 1) & mMask) {
+            if (mKeys[i] == kEmpty) {
+                return false;
+            }
+        }
+
+        // backward shift: 뒤따르는 cluster를 home bucket 방향으로 당겨온다.
+        mKeys[i] = kEmpty;
+        for (size_t j = (i + 1) & mMask; mKeys[j] != kEmpty; j = (j + 1) & mMask) {
+            const size_t home = bucketOf(mKeys[j]);
+            // home이 cyclic 구간 (i, j]에 있으면 그대로 둔다.
+            const bool stay = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (stay) {
+                continue;
+            }
+            mKeys[i] = mKeys[j];
+            mValues[i] = mValues[j];
+            mKeys[j] = kEmpty;
+            i = j;
+        }
+        --mSize;
+        return true;
+    }
+
+    void clear() {
+        std::fill(mKeys.begin(), mKeys.end(), kEmpty);
+        mSize = 0;
+    }
+
+    size_t size() const { return mSize; }
+
+  private:
+    static size_t roundUpPow2(size_t n) {
+        size_t cap = 8;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    size_t bucketOf(int key) const {
+        // fibonacci hashing (상위 bit 사용)
+        return (static_cast<uint32_t>(key) * 2654435769U) >> mShift;
+    }
+
+    void rehash(size_t newCapacity) {
+        std::vector<int> oldKeys = std::move(mKeys);
+        std::vector<int> oldValues = std::move(mValues);
+
+        mKeys.assign(newCapacity, kEmpty);
+        mValues.assign(newCapacity, 0);
+        mMask = newCapacity - 1;
+        mShift = 32;
+        for (size_t cap = newCapacity; cap > 1; cap >>= 1) {
+            --mShift;
+        }
+        mSize = 0;
+        for (size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldKeys[i] != kEmpty) {
+                insert(oldKeys[i], oldValues[i]);
+            }
+        }
+    }
+
+    std::vector<int> mKeys;
+    std::vector<int> mValues;
+    size_t mMask{0};
+    int mShift{32};
+    size_t mSize{0};
+};
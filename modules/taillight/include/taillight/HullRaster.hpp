@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/*
+ * projection 된 box corner (최대 8개)의 convex hull을 scanline으로 rasterize.
+ * hull이 걸치는 row만 방문하여 row마다 [colBegin, colEnd) 구간 하나를 전달하므로
+ * 이미지 크기의 buffer가 필요 없다.
+ * vertex는 pixel 좌표로 반올림하고, 경계 위의 pixel도 포함한다. (cv::fillConvexPoly와 같은 규칙)
+ */
+namespace HullRaster {
+
+constexpr int kMaxPoints = 8;
+
+struct Point {
+    int u;
+    int v;
+};
+
+// Andrew's monotone chain. hull은 반시계 방향, 반환값은 vertex 수.
+inline int convexHull(std::array<Point, kMaxPoints> &points, int n, Point *hull) {
+    std::sort(points.begin(), points.begin() + n, [](const Point &lhs, const Point &rhs) {
+        return lhs.u < rhs.u || (lhs.u == rhs.u && lhs.v < rhs.v);
+    });
+    auto cross = [](const Point &o, const Point &a, const Point &b) {
+        return static_cast<long>(a.u - o.u) * (b.v - o.v) -
+               static_cast<long>(a.v - o.v) * (b.u - o.u);
+    };
+
+    int k = 0;
+    for (int i = 0; i < n; ++i) { // lower hull
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+            --k;
+        }
+        hull[k++] = points[i];
+    }
+    for (int i = n - 2, lower = k + 1; i >= 0; --i) { // upper hull
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+            --k;
+        }
+        hull[k++] = points[i];
+    }
+    return std::max(k - 1, 1); // 마지막 점은 첫 점과 같다.
+}
+
+// us, vs: n (<= 8)개 점의 image 좌표. fn(row, colBegin, colEnd)
+template <typename Fn>
+void forEachSpan(const float *us, const float *vs, int n, int imgH, int imgW, Fn &&fn) {
+    std::array<Point, kMaxPoints> points;
+    for (int i = 0; i < n; ++i) {
+        points[i] = Point{static_cast<int>(us[i] + 0.5), static_cast<int>(vs[i] + 0.5)};
+    }
+    std::array<Point, 2 * kMaxPoints> hull;
+    const int numHull = convexHull(points, n, hull.data());
+
+    int minV = hull[0].v;
+    int maxV = hull[0].v;
+    for (int i = 1; i < numHull; ++i) {
+        minV = std::min(minV, hull[i].v);
+        maxV = std::max(maxV, hull[i].v);
+    }
+    const int rowBegin = std::max(minV, 0);
+    const int rowEnd = std::min(maxV + 1, imgH);
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        double left = imgW;
+        double right = -1;
+        for (int i = 0; i < numHull; ++i) {
+            const Point &a = hull[i];
+            const Point &b = hull[(i + 1) % numHull];
+            if (row < std::min(a.v, b.v) || row > std::max(a.v, b.v)) {
+                continue;
+            }
+            if (a.v == b.v) { // 수평 edge는 양 끝 모두 포함
+                left = std::min<double>(left, std::min(a.u, b.u));
+                right = std::max<double>(right, std::max(a.u, b.u));
+                continue;
+            }
+            const double u = a.u + static_cast<double>(row - a.v) * (b.u - a.u) / (b.v - a.v);
+            left = std::min(left, u);
+            right = std::max(right, u);
+        }
+
+        // 경계 pixel 포함. (정수 vertex에서 생기는 부동소수 오차 보정)
+        const int colBegin = std::max(static_cast<int>(std::ceil(left - 1e-9)), 0);
+        const int colEnd = std::min(static_cast<int>(std::floor(right + 1e-9)) + 1, imgW);
+        if (colBegin < colEnd) {
+            fn(row, colBegin, colEnd);
+        }
+    }
+}
+
+} // namespace HullRaster
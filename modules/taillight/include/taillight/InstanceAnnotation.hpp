@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/*
+ * Instance::isTailInSight()의 판단 값을 기록하는 debug annotation.
+ * 문자열을 만들지 않고 값만 미리 할당된 record에 저장하며, 문자열은 renderToImg()에서만 만든다.
+ * TAILLIGHT_NO_ANNOTATION으로 빌드하면 기록 코드가 compile 되지 않고,
+ * runtime에는 InstanceBatch::setAnnotation(false)로 끌 수 있다.
+ * rejection reason counter는 annotation 설정과 관계없이 항상 집계된다.
+ */
+#ifdef TAILLIGHT_NO_ANNOTATION
+constexpr bool kAnnotationCompiled = false;
+#else
+constexpr bool kAnnotationCompiled = true;
+#endif
+
+enum class RejectReason : uint8_t {
+    kNone,           // tail 인식 대상
+    kNotCar,         // 자동차가 아님
+    kTailAngle,      // tail을 보는 각도가 너무 큼
+    kTailOutOfImage, // tail corner가 이미지 밖
+    kTailTooSmall,   // tail projection이 너무 작음
+    kOccluded,       // 전방 물체에 가려짐
+    kNotEvaluated,   // isTailInSight()가 호출되지 않음 (projection 무효, 다른 camera 담당 등)
+};
+constexpr int kNumRejectReasons = static_cast<int>(RejectReason::kNotEvaluated) + 1;
+
+inline const char *rejectReasonName(RejectReason reason) {
+    switch (reason) {
+    case RejectReason::kNone:
+        return "none";
+    case RejectReason::kNotCar:
+        return "not_car";
+    case RejectReason::kTailAngle:
+        return "tail_angle";
+    case RejectReason::kTailOutOfImage:
+        return "tail_out_of_image";
+    case RejectReason::kTailTooSmall:
+        return "tail_too_small";
+    case RejectReason::kOccluded:
+        return "occluded";
+    case RejectReason::kNotEvaluated:
+        return "not_evaluated";
+    }
+    return "unknown";
+}
+
+// instance 하나의 판단 값. 판단 전에 탈락하면 뒤의 값은 기록되지 않는다. (-1)
+struct InstanceAnnotation {
+    float yawByViewDeg{std::numeric_limits<float>::quiet_NaN()};
+    int tailSize{-1};
+    int occluded{-1}; // tail 내 가려진 pixel 수
+    RejectReason reason{RejectReason::kNotEvaluated};
+
+    float occlusionRatio() const {
+        return tailSize > 0 && occluded >= 0 ? static_cast<float>(occluded) / tailSize : -1.0f;
+    }
+};
+
+typedef std::array<int, kNumRejectReasons> RejectCounts;
@@ -0,0 +1,123 @@
+#pragma once
+#include "InstanceAnnotation.hpp"
+#include "common.hpp"
+#include "instance.hpp"
+#include <string>
+#include <vector>
+
+/*
+ * 한 프레임의 모든 object를 structure-of-arrays 형태로 가지는 batch.
+ * add()로 box를 모은 뒤 project()에서 corner 생성, projection, culling, tail / bounding rect를
+ * 전체 object에 대해 한 번에 계산한다. (P = K * T_veh2cam 사용)
+ * corner array는 (8 x N) column-major 이므로 object 하나의 corner가 연속으로 놓인다.
+ * Instance는 batch의 index를 가리키는 view이다.
+ */
+class InstanceBatch {
+  public:
+    typedef Eigen::Array<float, 8, Eigen::Dynamic> CornerArray;
+
+    InstanceBatch(int capacity = 64) { reserve(capacity); }
+
+    void reserve(int capacity);
+    void clear();
+
+    void add(
+        int classId,
+        int trackId,
+        const std::array<float, 3> &xyz,
+        const std::array<float, 3> &lwh,
+        float yaw);
+
+    // 모든 object의 corner를 projection 하고 culling / rect 계산.
+    void project(const CalibParams &calib_params, int imgH, int imgW);
+
+    int size() const { return static_cast<int>(mClassIds.size()); }
+    Instance operator[](int idx) const { return Instance{*this, idx}; }
+
+    // ---------------------------------------------
+    // Per-object accessor (project() 이후 유효)
+    // ---------------------------------------------
+    int classId(int idx) const { return mClassIds[idx]; }
+    int trackId(int idx) const { return mTrackIds[idx]; }
+    float yaw(int idx) const { return mYaws[idx]; }
+    float dist(int idx) const { return mDists(idx); }
+    float yawByView(int idx) const { return mYawByViews(idx); }
+    bool isValidProjection(int idx) const { return mValidProjs[idx]; }
+    bool isTailInImage(int idx) const { return mTailInImages[idx]; }
+
+    // 0 ~ 3: tail corners, 4 ~ 7: front corners (image coordinate)
+    auto cornersU(int idx) const { return mCornersU.col(idx); }
+    auto cornersV(int idx) const { return mCornersV.col(idx); }
+    auto cornersCamZ(int idx) const { return mCornersCamZ.col(idx); }
+
+    // tail corners의 image 상 범위 (float, clipping 전)
+    float tailMinU(int idx) const { return mTailRange(0, idx); }
+    float tailMaxU(int idx) const { return mTailRange(1, idx); }
+    float tailMinV(int idx) const { return mTailRange(2, idx); }
+    float tailMaxV(int idx) const { return mTailRange(3, idx); }
+    // 8 corners의 image 상 범위 (float, clipping 전)
+    float boxMinU(int idx) const { return mBoxRange(0, idx); }
+    float boxMaxU(int idx) const { return mBoxRange(1, idx); }
+    float boxMinV(int idx) const { return mBoxRange(2, idx); }
+    float boxMaxV(int idx) const { return mBoxRange(3, idx); }
+
+    int imgH() const { return mImgH; }
+    int imgW() const { return mImgW; }
+
+    // ---------------------------------------------
+    // Debug annotation
+    // ---------------------------------------------
+    void setAnnotation(bool enable) { mAnnotation = enable; }
+    bool isAnnotating() const { return kAnnotationCompiled && mAnnotation; }
+
+    // 기록할 annotation. annotation이 꺼져 있으면 nullptr.
+    InstanceAnnotation *annotation(int idx) const {
+        if constexpr (!kAnnotationCompiled) {
+            return nullptr;
+        }
+        return mAnnotation ? &mAnnotations[idx] : nullptr;
+    }
+    const InstanceAnnotation &annotationAt(int idx) const { return mAnnotations[idx]; }
+
+    // 판단 결과 기록. reason이 kNone일 때만 true. (isTailInSight의 반환값으로 사용)
+    bool record(int idx, RejectReason reason) const {
+        ++mRejectCounts[static_cast<int>(reason)];
+        if (InstanceAnnotation *note = annotation(idx)) {
+            note->reason = reason;
+        }
+        return reason == RejectReason::kNone;
+    }
+
+    // 이번 프레임의 reason별 instance 수
+    RejectCounts rejectCounts() const;
+
+  private:
+    // input (add)
+    std::vector<int> mClassIds;
+    std::vector<int> mTrackIds;
+    std::vector<float> mCenters; // x, y, z 순으로 interleave
+    std::vector<float> mSizes;   // l, w, h 순으로 interleave
+    std::vector<float> mYaws;
+
+    // output (project). capacity 만큼 할당해두고 앞의 size()개의 column만 사용.
+    CornerArray mCornersX; // vehicle coordinate
+    CornerArray mCornersY;
+    CornerArray mCornersZ;
+    CornerArray mCornersCamZ; // camera coordinate의 depth
+    CornerArray mCornersU;    // image coordinate
+    CornerArray mCornersV;
+    Eigen::Array<float, 4, Eigen::Dynamic> mTailRange; // minU, maxU, minV, maxV
+    Eigen::Array<float, 4, Eigen::Dynamic> mBoxRange;  // minU, maxU, minV, maxV
+    Eigen::ArrayXf mDists;
+    Eigen::ArrayXf mYawByViews;
+    std::vector<char> mValidProjs;
+    std::vector<char> mTailInImages;
+
+    int mImgH{0};
+    int mImgW{0};
+
+    // debug용이므로 const에서도 수정 가능하도록.
+    mutable std::vector<InstanceAnnotation> mAnnotations;
+    mutable RejectCounts mRejectCounts{};
+    bool mAnnotation{true};
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "./common.hpp"
+
+/*
+ * 가까운 instance부터 bounding rect를 채워나가며, tail rect가 얼마나 가려졌는지 묻는 occlusion 구조.
+ * (row, col, height, width) 인자 순서는 ArrayXXb::block()과 같고, 이미지 밖은 잘라낸다.
+ */
+class OcclusionMap {
+  public:
+    virtual ~OcclusionMap() = default;
+
+    // 매 프레임 시작 시 호출. 크기가 같으면 memory를 재사용한다.
+    virtual void reset(int rows, int cols) = 0;
+    virtual void fill(int row, int col, int height, int width) = 0;
+    // 사각형 안에서 가려진 (한 번 이상 fill 된) pixel 수
+    virtual int count(int row, int col, int height, int width) const = 0;
+    // display / debugging 용 변환
+    virtual ArrayXXb toArray() const = 0;
+    virtual const char *name() const = 0;
+
+    // 한 row의 [colBegin, colEnd) 구간. silhouette (scanline) fill / count 용.
+    // raster 방식 (bitmask, row_prefix) 전용. rect_union은 span마다 사각형이 늘어난다.
+    void fillSpan(int row, int colBegin, int colEnd) {
+        fill(row, colBegin, 1, colEnd - colBegin);
+    }
+    int countSpan(int row, int colBegin, int colEnd) const {
+        return count(row, colBegin, 1, colEnd - colBegin);
+    }
+
+    int rows() const { return mRows; }
+    int cols() const { return mCols; }
+
+  protected:
+    // 이미지 밖으로 나가는 부분을 잘라낸다. 빈 사각형이면 false.
+    bool clip(int &row, int &col, int &height, int &width) const {
+        const int rowEnd = std::min(row + height, mRows);
+        const int colEnd = std::min(col + width, mCols);
+        row = std::max(row, 0);
+        col = std::max(col, 0);
+        height = rowEnd - row;
+        width = colEnd - col;
+        return height > 0 && width > 0;
+    }
+
+    int mRows{0};
+    int mCols{0};
+};
+
+// method: "bitmask", "row_prefix", "rect_union"
+// 세 방식의 count 결과는 같다. (tests/occlusionMap_test.cpp)
+std::unique_ptr<OcclusionMap> createOcclusionMap(const std::string &method);
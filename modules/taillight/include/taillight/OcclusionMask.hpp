@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "./OcclusionMap.hpp"
+
+/*
+ * 1 bit per pixel occlusion mask. 각 row는 64-bit word의 배열이다.
+ * 사각형 fill / count는 양 끝 word만 mask 처리하고 나머지는 word 단위로 OR / popcount 한다.
+ * fill 된 row 범위만 기억해두므로 reset()은 그 범위만 지운다.
+ */
+class OcclusionMask final : public OcclusionMap {
+  public:
+    OcclusionMask() = default;
+    OcclusionMask(int rows, int cols) { reset(rows, cols); }
+
+    // 크기가 같으면 memory를 재사용하고, fill 되었던 row만 0으로 지운다.
+    void reset(int rows, int cols) override {
+        if (rows != mRows || cols != mCols) {
+            mRows = rows;
+            mCols = cols;
+            mWordsPerRow = (cols + 63) / 64;
+            mWords.assign(static_cast<size_t>(rows) * mWordsPerRow, 0);
+        } else if (mDirtyBegin < mDirtyEnd) {
+            std::memset(
+                rowPtr(mDirtyBegin),
+                0,
+                static_cast<size_t>(mDirtyEnd - mDirtyBegin) * mWordsPerRow * sizeof(uint64_t));
+        }
+        mDirtyBegin = mRows;
+        mDirtyEnd = 0;
+    }
+
+    void fill(int row, int col, int height, int width) override {
+        if (!clip(row, col, height, width)) {
+            return;
+        }
+        const Span span = spanOf(col, width);
+        for (int r = row; r < row + height; ++r) {
+            uint64_t *words = rowPtr(r);
+            if (span.first == span.last) {
+                words[span.first] |= span.firstMask & span.lastMask;
+                continue;
+            }
+            words[span.first] |= span.firstMask;
+            for (int k = span.first + 1; k < span.last; ++k) {
+                words[k] = ~uint64_t{0};
+            }
+            words[span.last] |= span.lastMask;
+        }
+        mDirtyBegin = std::min(mDirtyBegin, row);
+        mDirtyEnd = std::max(mDirtyEnd, row + height);
+    }
+
+    // ArrayXXb::block().count()와 같은 값
+    int count(int row, int col, int height, int width) const override {
+        if (!clip(row, col, height, width)) {
+            return 0;
+        }
+        // 채워진 row 범위 밖은 0이다.
+        const int rowBegin = std::max(row, mDirtyBegin);
+        const int rowEnd = std::min(row + height, mDirtyEnd);
+        const Span span = spanOf(col, width);
+
+        int total = 0;
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            const uint64_t *words = rowPtr(r);
+            if (span.first == span.last) {
+                total += __builtin_popcountll(words[span.first] & span.firstMask & span.lastMask);
+                continue;
+            }
+            total += __builtin_popcountll(words[span.first] & span.firstMask);
+            for (int k = span.first + 1; k < span.last; ++k) {
+                total += __builtin_popcountll(words[k]);
+            }
+            total += __builtin_popcountll(words[span.last] & span.lastMask);
+        }
+        return total;
+    }
+
+    // row r의 64-bit word 배열 ((cols + 63) / 64개, 범위 밖 bit는 0)
+    const uint64_t *rowWords(int r) const { return rowPtr(r); }
+
+    ArrayXXb toArray() const override {
+        ArrayXXb arr = ArrayXXb::Zero(mRows, mCols);
+        for (int r = mDirtyBegin; r < mDirtyEnd; ++r) {
+            const uint64_t *words = rowPtr(r);
+            for (int c = 0; c < mCols; ++c) {
+                arr(r, c) = (words[c >> 6] >> (c & 63)) & 1U;
+            }
+        }
+        return arr;
+    }
+
+    const char *name() const override { return "bitmask"; }
+
+  private:
+    // [col, col + width) 에 해당하는 word 범위와 양 끝 word의 bit mask
+    struct Span {
+        int first;
+        int last;
+        uint64_t firstMask;
+        uint64_t lastMask;
+    };
+
+    static Span spanOf(int col, int width) {
+        const int lastCol = col + width - 1;
+        return Span{
+            col >> 6,
+            lastCol >> 6,
+            ~uint64_t{0} << (col & 63),
+            ~uint64_t{0} >> (63 - (lastCol & 63)),
+        };
+    }
+
+    uint64_t *rowPtr(int r) { return mWords.data() + static_cast<size_t>(r) * mWordsPerRow; }
+    const uint64_t *rowPtr(int r) const {
+        return mWords.data() + static_cast<size_t>(r) * mWordsPerRow;
+    }
+
+    int mWordsPerRow{0};
+    std::vector<uint64_t> mWords;
+    int mDirtyBegin{0}; // fill 된 row 범위 [mDirtyBegin, mDirtyEnd)
+    int mDirtyEnd{0};
+};
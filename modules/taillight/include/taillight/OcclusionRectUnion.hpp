@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "./OcclusionMap.hpp"
+
+/*
+ * raster 없이 fill 된 사각형 목록만 가지는 occlusion 구조.
+ * query 시 query 사각형과 겹치는 occluder만 잘라낸 뒤, x 좌표로 나눈 slab마다
+ * y interval의 합집합 길이를 더해 정확한 가려진 면적을 구한다. (sweep line)
+ * 비용은 occluder 수 n에만 의존하므로 (query 당 O(n^2 log n)) 이미지 해상도와 무관하고,
+ * 이미지 크기의 memory를 할당하지 않는다.
+ */
+class OcclusionRectUnion final : public OcclusionMap {
+  public:
+    OcclusionRectUnion() = default;
+    OcclusionRectUnion(int rows, int cols) { reset(rows, cols); }
+
+    void reset(int rows, int cols) override {
+        mRows = rows;
+        mCols = cols;
+        mRects.clear();
+    }
+
+    void fill(int row, int col, int height, int width) override {
+        if (!clip(row, col, height, width)) {
+            return;
+        }
+        mRects.push_back(Rect{row, col, row + height, col + width});
+    }
+
+    int count(int row, int col, int height, int width) const override {
+        if (!clip(row, col, height, width)) {
+            return 0;
+        }
+        const Rect query{row, col, row + height, col + width};
+
+        // query 안으로 잘라낸 occluder와 x 경계
+        mClipped.clear();
+        mXs.clear();
+        for (const Rect &rect : mRects) {
+            const Rect clipped{
+                std::max(rect.r0, query.r0),
+                std::max(rect.c0, query.c0),
+                std::min(rect.r1, query.r1),
+                std::min(rect.c1, query.c1),
+            };
+            if (clipped.r0 >= clipped.r1 || clipped.c0 >= clipped.c1) {
+                continue;
+            }
+            // query 전체를 덮는 occluder가 있으면 sweep 없이 끝.
+            if (clipped.r0 == query.r0 && clipped.c0 == query.c0 && clipped.r1 == query.r1 &&
+                clipped.c1 == query.c1) {
+                return height * width;
+            }
+            mClipped.push_back(clipped);
+            mXs.push_back(clipped.c0);
+            mXs.push_back(clipped.c1);
+        }
+        if (mClipped.empty()) {
+            return 0;
+        }
+        std::sort(mXs.begin(), mXs.end());
+        mXs.erase(std::unique(mXs.begin(), mXs.end()), mXs.end());
+
+        // x slab 마다 y interval 합집합의 길이 * slab 폭
+        int total = 0;
+        for (size_t k = 0; k + 1 < mXs.size(); ++k) {
+            const int slabBegin = mXs[k];
+            const int slabEnd = mXs[k + 1];
+            mIntervals.clear();
+            for (const Rect &rect : mClipped) {
+                if (rect.c0 <= slabBegin && rect.c1 >= slabEnd) {
+                    mIntervals.emplace_back(rect.r0, rect.r1);
+                }
+            }
+            if (mIntervals.empty()) {
+                continue;
+            }
+            std::sort(mIntervals.begin(), mIntervals.end());
+
+            int covered = 0;
+            int curBegin = mIntervals[0].first;
+            int curEnd = mIntervals[0].second;
+            for (size_t i = 1; i < mIntervals.size(); ++i) {
+                if (mIntervals[i].first > curEnd) {
+                    covered += curEnd - curBegin;
+                    curBegin = mIntervals[i].first;
+                }
+                curEnd = std::max(curEnd, mIntervals[i].second);
+            }
+            covered += curEnd - curBegin;
+            total += covered * (slabEnd - slabBegin);
+        }
+        return total;
+    }
+
+    ArrayXXb toArray() const override {
+        ArrayXXb arr = ArrayXXb::Zero(mRows, mCols);
+        for (const Rect &rect : mRects) {
+            arr.block(rect.r0, rect.c0, rect.r1 - rect.r0, rect.c1 - rect.c0) = true;
+        }
+        return arr;
+    }
+
+    const char *name() const override { return "rect_union"; }
+
+  private:
+    // [r0, r1) x [c0, c1)
+    struct Rect {
+        int r0;
+        int c0;
+        int r1;
+        int c1;
+    };
+
+    std::vector<Rect> mRects; // fill 된 occluder (이미지 안으로 잘라낸 것)
+
+    // count()의 작업 공간. 매 query마다 allocation 하지 않도록 재사용.
+    mutable std::vector<Rect> mClipped;
+    mutable std::vector<int> mXs;
+    mutable std::vector<std::pair<int, int>> mIntervals;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "./OcclusionMask.hpp"
+
+/*
+ * 사각형 coverage query를 row 당 O(1)에 답하는 occlusion 구조.
+ * bitmask에 더해 row마다 word 단위 prefix popcount를 가지므로, query 비용은 tail 폭과 무관하고
+ * 양 끝의 부분 word만 popcount 한다. (가까운 (넓은) tail이 많은 프레임에서 유리)
+ * fill은 bitmask fill에 더해 채운 word의 prefix를 다시 계산하고, 그 뒤 prefix에는 늘어난 수만 더한다.
+ * memory는 bitmask + row 당 (W / 64 + 1) * 2 byte. (1280 x 480이면 약 77 KB + 20 KB)
+ */
+class OcclusionRowPrefix final : public OcclusionMap {
+  public:
+    OcclusionRowPrefix() = default;
+    OcclusionRowPrefix(int rows, int cols) { reset(rows, cols); }
+
+    void reset(int rows, int cols) override {
+        if (rows != mRows || cols != mCols) {
+            if (cols > UINT16_MAX) {
+                std::cout << "OcclusionRowPrefix: too wide (" << cols << ")" << std::endl;
+                exit(1);
+            }
+            mRows = rows;
+            mCols = cols;
+            mPrefixPerRow = (cols + 63) / 64 + 1;
+            mPrefix.assign(static_cast<size_t>(rows) * mPrefixPerRow, 0);
+        } else if (mDirtyBegin < mDirtyEnd) {
+            std::fill(prefixPtr(mDirtyBegin), prefixPtr(mDirtyEnd), static_cast<uint16_t>(0));
+        }
+        mDirtyBegin = mRows;
+        mDirtyEnd = 0;
+        mMask.reset(rows, cols);
+    }
+
+    void fill(int row, int col, int height, int width) override {
+        if (!clip(row, col, height, width)) {
+            return;
+        }
+        mMask.fill(row, col, height, width);
+
+        // 채운 word 범위는 다시 popcount 하고, 그 뒤의 prefix에는 늘어난 수만 더한다.
+        const int first = col >> 6;
+        const int last = (col + width - 1) >> 6;
+        for (int r = row; r < row + height; ++r) {
+            const uint64_t *words = mMask.rowWords(r);
+            uint16_t *prefix = prefixPtr(r);
+            const uint16_t oldEnd = prefix[last + 1];
+            for (int k = first; k <= last; ++k) {
+                prefix[k + 1] = prefix[k] + __builtin_popcountll(words[k]);
+            }
+            const uint16_t added = prefix[last + 1] - oldEnd;
+            if (added) {
+                for (int k = last + 2; k < mPrefixPerRow; ++k) {
+                    prefix[k] += added;
+                }
+            }
+        }
+        mDirtyBegin = std::min(mDirtyBegin, row);
+        mDirtyEnd = std::max(mDirtyEnd, row + height);
+    }
+
+    int count(int row, int col, int height, int width) const override {
+        if (!clip(row, col, height, width)) {
+            return 0;
+        }
+        // 채워진 row 범위 밖은 0이다.
+        const int rowBegin = std::max(row, mDirtyBegin);
+        const int rowEnd = std::min(row + height, mDirtyEnd);
+
+        int total = 0;
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            total += rank(r, col + width) - rank(r, col);
+        }
+        return total;
+    }
+
+    ArrayXXb toArray() const override { return mMask.toArray(); }
+
+    const char *name() const override { return "row_prefix"; }
+
+  private:
+    // row r의 [0, c) 범위에서 채워진 pixel 수
+    int rank(int r, int c) const {
+        const int k = c >> 6;
+        const int bits = c & 63;
+        int total = prefixPtr(r)[k];
+        if (bits) {
+            total += __builtin_popcountll(mMask.rowWords(r)[k] & ((uint64_t{1} << bits) - 1));
+        }
+        return total;
+    }
+
+    uint16_t *prefixPtr(int r) { return mPrefix.data() + static_cast<size_t>(r) * mPrefixPerRow; }
+    const uint16_t *prefixPtr(int r) const {
+        return mPrefix.data() + static_cast<size_t>(r) * mPrefixPerRow;
+    }
+
+    OcclusionMask mMask;
+    int mPrefixPerRow{1};
+    std::vector<uint16_t> mPrefix; // row별 [0, k) word의 popcount (k = 0 ~ W / 64)
+    int mDirtyBegin{0};            // fill 된 row 범위 [mDirtyBegin, mDirtyEnd)
+    int mDirtyEnd{0};
+};
@@ -1,24 +1,75 @@
 #pragma once
+#include "EmbeddingPool.hpp"
+#include "FlatIdMap.hpp"
+#include "CameraRegistry.hpp"
+#include "CropPreproc.hpp"
 #include "TrackedInst.hpp"
-#include "instance.hpp"
+#include "WorkerPool.hpp"
+#include "trt_utils/inputAdapter.h"
 
-class RegressInferAgent;
-class UNetInferAgent;
-class CNN3DInferAgent;
+template <typename Spec> class InferAgent;
+struct RegressSpec;
+struct UNetSpec;
+struct CNN3DSpec;
+class TrackerCheckpoint;
+
+// regress 된 tail 영역. roi는 cameraIdx camera의 image 좌표.
+struct TailRoi {
+    int cameraIdx;
+    cv::Rect roi;
+};
 
 class TailRecogManager {
 
   public:
-    TailRecogManager();
+    TailRecogManager(
+        const TrackerParams &trackerParams = TrackerParams{},
+        const InferBackendParams &backendParams = InferBackendParams{});
     ~TailRecogManager();
-    std::map<int, cv::Rect>
-    updateDet(cv::Mat img, std::vector<Instance> &instVec, ArrayXXb &occMask);
+    // cameras는 imgs (camera index 순서)로 project() 된 상태여야 한다.
+    // 모든 camera의 tail을 모아 한 번에 inference 하고 tracker는 프레임당 한 번 update 한다.
+    std::map<int, TailRoi> updateDet(const std::vector<cv::Mat> &imgs, CameraRegistry &cameras);
 
+    // 이번 프레임에 infer 해야 하는 track만 CNN3D를 돌리고, 나머지는 cache 된 state 반환.
+    // infer 할 track이 batch 크기보다 많으면 staleness와 거리로 우선순위를 정하고,
+    // 선택되지 못한 track은 다음 프레임에 우선순위가 올라간다.
     std::map<int, int> infer();
 
+    // trackId -> 마지막 CNN3D inference 이후 지난 프레임 수 (결과가 없으면 -1)
+    std::map<int, int> getInferAges() const;
+
+    // 프레임 내 병렬 작업용 thread pool. (CameraRegistry::project 등, main thread 전용)
+    WorkerPool &workerPool() { return mPreprocPool; }
+
+    // tracker state (trackId, detection bitmask, embedding window) snapshot.
+    // save는 background thread에서 기록되며, 이전 기록이 진행 중이면 false.
+    bool saveCheckpoint(const std::string &path);
+    // 재시작 시 첫 프레임 전에 호출. maxAgeSec 보다 오래된 snapshot은 무시한다.
+    // track이 이미 있으면 복원하지 않고 false.
+    bool loadCheckpoint(const std::string &path, double maxAgeSec);
+
   private:
-    std::list<TrackedInst> mTrackedInsts;
-    std::unique_ptr<RegressInferAgent> mRegressAgent;
-    std::unique_ptr<UNetInferAgent> mUNetAgent;
-    std::unique_ptr<CNN3DInferAgent> mInferAgent;
+    void associate(const std::vector<TrackerInput> &inputs);
+    int storeEmbedding(int embSlot);
+    bool admitTrack(const TrackerInput &input);
+    void removeTrack(size_t idx);
+    void reindexTracks(); // mTrackedInsts 순서대로 mTrackIndex를 다시 만든다.
+
+    const TrackerParams mTrackerParams;
+    EmbeddingPool mEmbPool; // mTrackedInsts보다 먼저 생성, 나중에 파괴되어야 한다.
+    std::vector<TrackedInst> mTrackedInsts; // maxTracks 만큼 reserve 된 track pool (생성 순서)
+    FlatIdMap mTrackIndex;                  // trackId -> mTrackedInsts index
+    std::vector<char> mTrackMatched; // associate()에서 이번 프레임 matched 여부
+    int64_t mFrameIdx{0};            // updateDet 호출 횟수
+    std::vector<std::pair<float, size_t>> mSchedCandidates; // (priority, track idx)
+    std::unique_ptr<TrackerCheckpoint> mCheckpoint; // mEmbPool보다 먼저 파괴되어야 한다.
+    // agent input tensor의 형식 ({B, H, W, C}, RGB, 0 ~ 1).
+    // byte input engine (execBuildOnly u8)이면 변환은 engine에서 하고 host는 BGR byte만 쓴다.
+    const InputAdapter::Spec mInputSpec{};
+    CropPreproc::Params mRegPreproc{RegCfg::inH, RegCfg::inW};
+    CropPreproc::Params mUNetPreproc{UNetCfg::inH, UNetCfg::inW};
+    std::unique_ptr<InferAgent<RegressSpec>> mRegressAgent;
+    std::unique_ptr<InferAgent<UNetSpec>> mUNetAgent;
+    std::unique_ptr<InferAgent<CNN3DSpec>> mInferAgent;
+    WorkerPool mPreprocPool; // tail crop preprocess (Regress, UNet input), camera projection
 };
@@ -1,83 +1,80 @@
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
-#include <list>
+#include <limits>
 #include <vector>
 
+#include "./FeatureRing.hpp"
 #include "./common.hpp"
 
+// encodedTail은 UNetInferAgent output buffer의 slot index로 참조한다. (복사 없음)
 struct TrackerInput {
     int trackId;
-    std::vector<float> encodedTail;
+    int embSlot;
+    float dist; // Instance::dist(). track pool이 가득 찼을 때 admission 기준.
 };
 
+// TrackedInst의 feature는 EmbeddingPool slot 참조로만 저장된다.
 class TrackedInst {
   public:
-    TrackedInst(const TrackerInput &input) : mTrackId(input.trackId) {
-        mEncodedImgs =
-            std::deque<std::vector<float>>(kLenSeq - 1, std::vector<float>(kEncodedSize, 0.0f));
-        mEncodedImgs.push_back(input.encodedTail);
+    TrackedInst(int trackId, int poolSlot, float dist, int64_t frameIdx, EmbeddingPool &pool)
+        : mEncodedImgs(pool), mTrackId(trackId), mDist(dist), mLastInferFrame(frameIdx) {
+        // window는 zero frame으로 초기화되어 있으므로 newest만 채워준다.
+        mEncodedImgs.push(poolSlot);
 
-        mbDetected = std::deque<bool>(kLenSeq - 1, false);
-        mbDetected.push_back(true);
+        pushDetected(true);
     }
 
-    void update(std::list<TrackerInput> &inputs) {
-        mEncodedImgs.pop_front();
-        mbDetected.pop_front();
-
-        // inputs 중에 matched trackId가 있는 경우 early return
-        // 그리고 inputs에서 해당 elem 제거해줌.
-        for (auto it = inputs.begin(); it != inputs.end(); ++it) {
-            if (it->trackId == mTrackId) {
-                // 이전 프레임이 false였다면 copy해줌.
-                if (mbDetected.back() == false) {
-                    mEncodedImgs.back() = it->encodedTail;
-                }
-                mEncodedImgs.push_back(it->encodedTail);
-                mbDetected.push_back(true);
-
-                inputs.erase(it);
-                return;
-            }
+    // checkpoint 복원용. poolSlots는 window의 slot들 (oldest -> newest, lenSeq()개)
+    // 거리는 다음 detection 전까지 알 수 없으므로 무한대로 둔다.
+    TrackedInst(int trackId, uint32_t detectedBits, const int *poolSlots, EmbeddingPool &pool)
+        : mEncodedImgs(pool), mDetectedBits(detectedBits & kDetectedMask), mTrackId(trackId),
+          mDist(std::numeric_limits<float>::infinity()) {
+        for (int t = 0; t < kLenSeq; ++t) {
+            mEncodedImgs.push(poolSlots[t]);
         }
+    }
 
-        // inputs 중에 matched trackId가 없는 경우
-        // 이전 프레임에서 복사해오던지, dummy 집어 넣음.
-        if (mbDetected.back() == true) {
-            mEncodedImgs.push_back(mEncodedImgs.back());
+    // 이번 프레임에 matched detection이 있는 경우. poolSlot은 새 embedding의 pool slot.
+    void update(int poolSlot, float dist) {
+        mDist = dist;
+        // 이전 프레임이 false였다면 같은 embedding으로 back-fill. (slot 공유)
+        if (!lastDetected()) {
+            mEncodedImgs.assignBack(poolSlot);
+        }
+        mEncodedImgs.push(poolSlot);
+        pushDetected(true);
+    }
+
+    // matched detection이 없는 경우
+    // 이전 프레임을 참조하던지, dummy (zero frame) 집어 넣음.
+    void updateMissed() {
+        if (lastDetected()) {
+            mEncodedImgs.pushRepeat();
         } else {
-            mEncodedImgs.emplace_back(kEncodedSize, 0.0f);
+            mEncodedImgs.pushZero();
         }
-        mbDetected.push_back(false);
-        return;
+        pushDetected(false);
     }
 
-    bool shouldRemoved() const {
-        int sum = std::accumulate(mbDetected.end() - 3, mbDetected.end(), 0);
-        return sum == 0 ? true : false;
+    bool shouldRemoved(const TrackerParams &params) const {
+        return countLatest(params.removeWindow) == 0;
     }
 
-    bool canInfered() const {
+    bool canInfered(const TrackerParams &params) const {
         // 1. Check first_detect
-        size_t first_detect;
-        for (first_detect = 0; first_detect < mbDetected.size(); ++first_detect) {
-            if (mbDetected[first_detect]) {
-                break;
-            }
-        }
-        if (first_detect > 8) {
+        if (firstDetect() > params.firstDetectMax) {
             return false;
         }
-        // 2. Check sum_latest8
-        const int sum_latest8 = std::accumulate(mbDetected.end() - 8, mbDetected.end(), 0);
-        if (sum_latest8 < 6) {
+        // 2. Check sum_latest
+        if (countLatest(params.recentWindow) < params.recentMinCount) {
             return false;
         }
         // 3. Check sum
-        const int sum = std::accumulate(mbDetected.begin(), mbDetected.end(), 0);
-        if (sum < 8) {
+        if (__builtin_popcount(mDetectedBits) < params.totalMinCount) {
             return false;
         }
 
@@ -86,36 +83,78 @@ class TrackedInst {
 
     void printDetected() const {
         std::cout << trackId() << "   ";
-        for (const auto &elem : mbDetected) {
-            std::cout << elem << " ";
+        for (int t = 0; t < kLenSeq; ++t) {
+            std::cout << ((mDetectedBits >> t) & 1U) << " ";
         }
         std::cout << std::endl;
     }
 
-    std::vector<float> getConcatedFeats() const {
-        const size_t inputSize = mEncodedImgs[0].size() * mEncodedImgs.size();
-
-        std::vector<float> concat;
-        concat.reserve(inputSize);
-        for (const auto &elem : mEncodedImgs) {
-            concat.insert(concat.end(), elem.begin(), elem.end());
+    // ---------------------------------------------
+    // CNN3D 결과 cache (strided inference)
+    // ---------------------------------------------
+    // 마지막 inference 이후 stride 프레임이 지났으면 다시 infer 해야 한다.
+    bool isInferDue(int64_t frameIdx, int stride) const {
+        if (!hasCachedState()) {
+            return true;
         }
+        return frameIdx - mLastInferFrame >= stride;
+    }
 
-        if (concat.size() != kLenSeq * kEncodedSize) {
-            std::cout << "Concat Size Error" << std::endl;
-            exit(1);
-        }
+    void setInferResult(int state, int64_t frameIdx) {
+        mCachedState = state;
+        mLastInferFrame = frameIdx;
+    }
 
-        return concat;
+    bool hasCachedState() const { return mCachedState >= 0; }
+    int cachedState() const { return mCachedState; }
+    // 마지막 inference (없으면 track 생성) 이후 지난 프레임 수. scheduling의 staleness.
+    int64_t inferAge(int64_t frameIdx) const { return frameIdx - mLastInferFrame; }
+
+    // CNN3D scheduling 우선순위: staleness(frame) - distWeight * dist(m)
+    // 거리를 모르는 track (checkpoint 복원, 무한대)은 거리 항을 빼고 staleness만 사용한다.
+    // (distWeight가 0이면 0 * inf = NaN이 되어 정렬이 깨진다.)
+    float schedPriority(int64_t frameIdx, float distWeight) const {
+        const float staleness = static_cast<float>(inferAge(frameIdx));
+        return std::isfinite(mDist) ? staleness - distWeight * mDist : staleness;
     }
 
+    // window를 dst (kLenSeq * kEncodedSize floats)에 시간 순서대로 FP32로 한 번에 써넣는다.
+    void writeConcatedFeats(float *dst) const { mEncodedImgs.writeWindow(dst); }
+
     // getters, setters
     int trackId() const { return mTrackId; }
+    uint32_t detectedBits() const { return mDetectedBits; }
+    float dist() const { return mDist; } // 마지막 detection의 거리
+    int slotAt(int t) const { return mEncodedImgs.slotAt(t); }
+    static constexpr int lenSeq() { return kLenSeq; }
 
   private:
-    std::deque<std::vector<float>> mEncodedImgs;
-    std::deque<bool> mbDetected;
-    const int mTrackId;
     static constexpr int kLenSeq = CNN3DCfg::inSeqLen;
     static constexpr int kEncodedSize = ENCODED_TAIL_SIZE;
+    static_assert(kLenSeq < 32, "detection history must fit in mDetectedBits");
+    static constexpr uint32_t kDetectedMask = (1U << kLenSeq) - 1;
+
+    // bit t: window 내 t번째 frame (t = 0: oldest, t = kLenSeq - 1: newest)의 detect 여부
+    void pushDetected(bool detected) {
+        mDetectedBits = (mDetectedBits >> 1) | (static_cast<uint32_t>(detected) << (kLenSeq - 1));
+    }
+
+    bool lastDetected() const { return (mDetectedBits >> (kLenSeq - 1)) & 1U; }
+
+    // 최근 n 프레임 중 detect된 프레임 수
+    int countLatest(int n) const {
+        n = std::clamp(n, 0, kLenSeq);
+        return __builtin_popcount(mDetectedBits >> (kLenSeq - n));
+    }
+
+    // 첫 detect의 window 내 index. detect이 없으면 kLenSeq.
+    int firstDetect() const { return mDetectedBits ? __builtin_ctz(mDetectedBits) : kLenSeq; }
+
+    FeatureRing<kLenSeq> mEncodedImgs;
+    uint32_t mDetectedBits{0};
+    int mTrackId;
+    float mDist;
+
+    int mCachedState{-1};       // 마지막 CNN3D 결과. (-1: 없음)
+    int64_t mLastInferFrame{0}; // 마지막 CNN3D 프레임. 결과가 없으면 생성 프레임
 };
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * 프레임 내의 독립적인 작업 (crop preprocess 등)을 나누어 실행하는 고정 크기 thread pool.
+ * parallelFor()는 호출한 thread도 작업에 참여하며 모든 index가 끝나야 반환하므로,
+ * 반환 직후 결과를 바로 사용할 수 있다.
+ * index마다 결과를 쓰는 위치가 겹치지 않으면 결과는 실행 순서와 무관하다.
+ */
+class WorkerPool {
+  public:
+    // numWorkers: 호출 thread 외에 추가로 생성할 thread 수. 0이면 호출 thread에서 순서대로 실행.
+    explicit WorkerPool(int numWorkers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    int numWorkers() const { return static_cast<int>(mThreads.size()); }
+
+    // fn(i) for i in [0, n). 한 번에 하나의 호출만 가능. (main thread 전용)
+    void parallelFor(int n, const std::function<void(int)> &fn);
+
+  private:
+    void workerLoop();
+    void runIndices(const std::function<void(int)> *job, int n);
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake; // 새 작업 또는 종료
+    std::condition_variable mIdle; // 작업 중인 worker가 없어짐
+
+    // mMutex로 보호. worker는 generation이 바뀌면 현재 작업에 참여한다.
+    const std::function<void(int)> *mJob{nullptr};
+    int mJobSize{0};
+    uint64_t mGeneration{0};
+    int mActive{0}; // 작업에 참여 중인 worker 수
+    bool mStop{false};
+
+    std::atomic<int> mNextIdx{0};
+};
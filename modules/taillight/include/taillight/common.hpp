@@ -3,7 +3,10 @@
 #include <Eigen/Geometry>
 #include <array>
 #include <iostream>
-#include <numeric>
+#include <map>
+#include <string>
+
+#include "./FeatureCodec.hpp"
 
 typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> MatrixXXb;
 typedef Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic> ArrayXXb;
@@ -15,6 +18,7 @@ struct CalibParams {
     const Eigen::Matrix4f RLinv;
     const Eigen::Matrix4f T_veh2cam;
     const Eigen::Matrix3f K;
+    const Eigen::Matrix<float, 3, 4> P_veh2img; // K * T_veh2cam (vehicle -> image, homogeneous)
 
     CalibParams(
         const std::array<float, 16> &RT_vals,
@@ -25,7 +29,8 @@ struct CalibParams {
           RL{Eigen::Matrix<float, 4, 4, Eigen::RowMajor>{RL_vals.data()}},
           RLinv{RL.inverse()},
           T_veh2cam{RLinv * RTinv},
-          K{Eigen::Matrix<float, 3, 3, Eigen::RowMajor>{K_vals.data()}} {}
+          K{Eigen::Matrix<float, 3, 3, Eigen::RowMajor>{K_vals.data()}},
+          P_veh2img{K * T_veh2cam.topRows<3>()} {}
 
     void printParams() const {
         std::cout << "RT\n" << RT << std::endl;
@@ -34,6 +39,102 @@ struct CalibParams {
     }
 };
 
+// TrackedInst의 detection history gating parameter. (config.toml의 [tracker])
+struct TrackerParams {
+    int removeWindow = 3;   // 최근 removeWindow 프레임 동안 detect이 없으면 track 제거
+    int firstDetectMax = 8; // window 내 첫 detect의 index가 이보다 크면 infer 불가
+    int recentWindow = 8;   // 최근 recentWindow 프레임 중
+    int recentMinCount = 6; // recentMinCount 번 이상 detect 되어야 infer 가능
+    int totalMinCount = 8;  // window 전체에서 totalMinCount 번 이상 detect 되어야 infer 가능
+
+    int maxTracks = 64; // track pool 크기. 가득 차면 가까운 instance 우선으로 admission
+    int inferStride = 1; // track마다 inferStride 프레임에 한 번 CNN3D. 나머지는 cache 결과
+    // CNN3D batch보다 infer 할 track이 많을 때의 우선순위: staleness(frame) - weight * dist(m)
+    float schedDistWeight = 0.5f;
+    int preprocWorkers = 3; // crop preprocess, camera projection에 추가로 사용할 thread 수
+
+    FeatStorage featStorage = FeatStorage::kFP32; // history feature 저장 형식
+
+    void printParams() const {
+        std::cout << "removeWindow " << removeWindow << std::endl;
+        std::cout << "firstDetectMax " << firstDetectMax << std::endl;
+        std::cout << "recentWindow " << recentWindow << std::endl;
+        std::cout << "recentMinCount " << recentMinCount << std::endl;
+        std::cout << "totalMinCount " << totalMinCount << std::endl;
+        std::cout << "maxTracks " << maxTracks << std::endl;
+        std::cout << "inferStride " << inferStride << std::endl;
+        std::cout << "schedDistWeight " << schedDistWeight << std::endl;
+        std::cout << "preprocWorkers " << preprocWorkers << std::endl;
+        std::cout << "featStorage " << featStorageName(featStorage) << std::endl;
+    }
+};
+
+// agent의 inference 실행 방식.
+// kCpu는 model 연산 없이 shape / type만 맞춘 결정적 output (GPU 없는 환경의 실행 / profiling)
+// kReplay는 record 된 GPU run의 output을 그대로 재생
+enum class InferBackendType { kTensorRT, kCpu, kReplay };
+
+inline InferBackendType parseInferBackend(const std::string &name) {
+    if (name == "tensorrt") {
+        return InferBackendType::kTensorRT;
+    } else if (name == "cpu") {
+        return InferBackendType::kCpu;
+    } else if (name == "replay") {
+        return InferBackendType::kReplay;
+    }
+    std::cout << "Invalid inference backend: " << name << " (tensorrt, cpu, replay)" << std::endl;
+    exit(1);
+}
+
+inline const char *inferBackendName(InferBackendType type) {
+    switch (type) {
+    case InferBackendType::kTensorRT:
+        return "tensorrt";
+    case InferBackendType::kCpu:
+        return "cpu";
+    case InferBackendType::kReplay:
+        return "replay";
+    }
+    return "unknown";
+}
+
+// 재생할 기록을 찾는 기준
+enum class ReplayMatch {
+    kSequence, // 호출 순서. input이 기록과 다르면 알린다.
+    kDigest,   // input digest가 같은 기록
+};
+
+inline ReplayMatch parseReplayMatch(const std::string &name) {
+    if (name == "sequence") {
+        return ReplayMatch::kSequence;
+    } else if (name == "digest") {
+        return ReplayMatch::kDigest;
+    }
+    std::cout << "Invalid replay match: " << name << " (sequence, digest)" << std::endl;
+    exit(1);
+}
+
+// engine 하나의 시간 model. (GPU 없는 환경에서 inference 시간 흉내, config.toml의 [latency])
+struct LatencyModel {
+    double fixedMs = 0.0;   // execute 당 고정 비용
+    double perItemMs = 0.0; // 유효 batch 하나 당 추가 비용
+    double copyGBps = 0.0;  // host <-> device 복사 bandwidth. 0이면 복사 비용 없음
+};
+
+// (config.toml의 [inference], [latency])
+struct InferBackendParams {
+    InferBackendType type = InferBackendType::kTensorRT;
+    std::string engineDir; // .trt 파일의 directory. 비어 있으면 $HOME/Projects/.../onnx/Output
+    // 비어 있지 않으면 agent의 execute마다 <recordDir>/<engine>.inflog에 input digest / output 기록
+    std::string recordDir;
+    std::string replayDir; // kReplay가 읽는 기록의 directory
+    ReplayMatch replayMatch = ReplayMatch::kSequence;
+    bool cpuByteInput = false; // kCpu의 image input을 byte input engine (execBuildOnly u8)처럼 받는다
+    // engine 이름 (tail_det, taillight_unet, taillight_3Dconv) -> 시간 model. 있는 engine만 지연
+    std::map<std::string, LatencyModel> latencyModels;
+    bool latencySpin = false; // sleep 대신 busy-wait
+};
+
 // angleDiff (-pi, pi)
 inline float angleDiff(float toAngle, float fromAngle) {
     return remainder((toAngle - fromAngle), 2 * M_PI);
@@ -43,19 +144,27 @@ namespace Cfg {
 constexpr int batchSize = 8;
 }
 
+// agent tensor shape의 element 수. (compile time)
+template <size_t N> constexpr int dimsVolume(const std::array<int, N> &dims) {
+    int numEl = 1;
+    for (int d : dims) {
+        numEl *= d;
+    }
+    return numEl;
+}
+
 namespace RegCfg {
 constexpr int inB = Cfg::batchSize;
 constexpr int inH = 224;
 constexpr int inW = 224;
 constexpr int inC = 3;
-inline const std::vector<int> inDims = {inB, inH, inW, inC};
-inline const int inNumEl = std::accumulate(inDims.begin(), inDims.end(), 1, std::multiplies<>());
+constexpr std::array<int, 4> inDims = {inB, inH, inW, inC};
+constexpr int inNumEl = dimsVolume(inDims);
 
 constexpr int outB = Cfg::batchSize;
 constexpr int outC = 4;
-inline const std::vector<int> outDims = {outB, outC};
-inline const int outNumEl =
-    std::accumulate(outDims.begin(), outDims.end(), 1, std::multiplies<>());
+constexpr std::array<int, 2> outDims = {outB, outC};
+constexpr int outNumEl = dimsVolume(outDims);
 } // namespace RegCfg
 
 namespace UNetCfg {
@@ -64,17 +173,16 @@ constexpr int inSeqLen = 1;
 constexpr int inH = 112;
 constexpr int inW = 112;
 constexpr int inC = 3;
-inline const std::vector<int> inDims = {inB, inSeqLen, inH, inW, inC};
-inline const int inNumEl = std::accumulate(inDims.begin(), inDims.end(), 1, std::multiplies<>());
+constexpr std::array<int, 5> inDims = {inB, inSeqLen, inH, inW, inC};
+constexpr int inNumEl = dimsVolume(inDims);
 
 constexpr int outB = Cfg::batchSize;
 constexpr int outSeqLen = 1;
 constexpr int outC = 64;
 constexpr int outH = 28;
 constexpr int outW = 28;
-inline const std::vector<int> outDims = {outB, outSeqLen, outC, outH, outW};
-inline const int outNumEl =
-    std::accumulate(outDims.begin(), outDims.end(), 1, std::multiplies<>());
+constexpr std::array<int, 5> outDims = {outB, outSeqLen, outC, outH, outW};
+constexpr int outNumEl = dimsVolume(outDims);
 } // namespace UNetCfg
 
 namespace CNN3DCfg {
@@ -83,14 +191,13 @@ constexpr int inSeqLen = 16;
 constexpr int inC = UNetCfg::outC;
 constexpr int inH = UNetCfg::outH;
 constexpr int inW = UNetCfg::outW;
-inline const std::vector<int> inDims = {inB, inSeqLen, inC, inH, inW};
-inline const int inNumEl = std::accumulate(inDims.begin(), inDims.end(), 1, std::multiplies<>());
+constexpr std::array<int, 5> inDims = {inB, inSeqLen, inC, inH, inW};
+constexpr int inNumEl = dimsVolume(inDims);
 
 constexpr int outB = Cfg::batchSize;
 constexpr int outC = 1;
-inline const std::vector<int> outDims = {outB, outC};
-inline const int outNumEl =
-    std::accumulate(outDims.begin(), outDims.end(), 1, std::multiplies<>());
+constexpr std::array<int, 2> outDims = {outB, outC};
+constexpr int outNumEl = dimsVolume(outDims);
 } // namespace CNN3DCfg
 
 constexpr int ENCODED_TAIL_SIZE = UNetCfg::outC * UNetCfg::outH * UNetCfg::outW;
@@ -1,45 +1,38 @@
 #pragma once
+#include "OcclusionMap.hpp"
 #include "common.hpp"
 #include <opencv2/opencv.hpp>
 
+class InstanceBatch;
+
+// InstanceBatch 내 object 하나에 대한 view. geometry는 InstanceBatch::project()에서 계산된다.
 class Instance {
   public:
-    Instance(
-        int classId,
-        int trackId,
-        std::array<float, 3> xyz,
-        std::array<float, 3> lwh,
-        float yaw,
-        const CalibParams &calib_params);
+    Instance(const InstanceBatch &batch, int idx) : mBatch(&batch), mIdx(idx) {}
 
-    bool isAnyCornersInImage(int imgH, int imgW) const;
+    bool isAnyCornersInImage() const;
     bool isAllCornersFrontOfCam() const;
-    bool isValidProjection(int imgH, int imgW) const;
+    bool isValidProjection() const;
     bool isCar() const; // 차종 상관없이 차인지 여부
 
     void renderToImg(cv::Mat &img) const;
 
-    bool isTailInSight(int imgH, int imgW, const ArrayXXb &occMask) const;
-    MatrixXXb getMask(int imgH, int imgW, bool tailOnly) const;
-    std::tuple<int, int, int, int> getTailRect(int imgH, int imgW, float padRatio) const;
-    std::tuple<int, int, int, int> getBoundingRect(int imgH, int imgW) const;
+    // silhouette이면 tail 크기와 가려진 정도를 tail rect 대신 tail corner의 convex hull로 계산.
+    bool isTailInSight(const OcclusionMap &occMask, bool silhouette = false) const;
+    // projection 된 box (tailOnly면 tail 면)의 convex hull을 occMask에 채운다.
+    void fillSilhouette(OcclusionMap &occMask, bool tailOnly = false) const;
+    // convex hull 내 (가려진 pixel 수, 전체 pixel 수)
+    std::pair<int, int> silhouetteCoverage(const OcclusionMap &occMask, bool tailOnly) const;
+    MatrixXXb getMask(bool tailOnly) const;
+    std::tuple<int, int, int, int> getTailRect(float padRatio) const;
+    std::tuple<int, int, int, int> getBoundingRect() const;
 
     // getter, setter
-    float dist() const { return mDist; }
-    int trackId() const { return mTrackId; }
+    float dist() const;
+    int trackId() const;
+    int batchIdx() const { return mIdx; }
 
   private:
-    int mClassId;
-    int mTrackId;
-    Eigen::Vector3f mXyzCenter;
-    Eigen::Vector3f mLwh;
-    float mYaw;
-
-    Eigen::Matrix<float, 3, 8> mCorners3D;    // vehicle coordinate
-    Eigen::Matrix<float, 3, 8> mCornersCam3D; // camera coordinate
-    Eigen::Matrix<float, 2, 8> mCorners2D;    // image coordinate
-
-    float mDist;
-
-    mutable std::string mDisplayStr = ""; // debuge용이므로 const에서도 수정 가능하도록.
+    const InstanceBatch *mBatch;
+    int mIdx;
 };
@@ -0,0 +1,125 @@
+#include "taillight/CameraRegistry.hpp"
+#include <iostream>
+#include <limits>
+
+CameraRegistry::CameraRegistry(const std::string &occlusionMethod, bool silhouette)
+    : mOcclusionMethod(occlusionMethod), mSilhouette(silhouette) {
+    // rect_union의 count는 사각형 수 n에 대해 O(n^2 log n)이라 1 row span 수백 개를 감당하지 못한다.
+    if (mSilhouette && mOcclusionMethod == "rect_union") {
+        std::cout << "Occlusion: silhouette requires bitmask or row_prefix (not rect_union)"
+                  << std::endl;
+        exit(1);
+    }
+}
+
+int CameraRegistry::addCamera(const std::string &name, const CalibParams &calib) {
+    if (find(name) >= 0) {
+        std::cout << "Duplicated camera name: " << name << std::endl;
+        exit(1);
+    }
+    mCameras.emplace_back(name, calib, createOcclusionMap(mOcclusionMethod));
+    return size() - 1;
+}
+
+int CameraRegistry::find(const std::string &name) const {
+    for (int cameraIdx = 0; cameraIdx < size(); ++cameraIdx) {
+        if (mCameras[cameraIdx].name == name) {
+            return cameraIdx;
+        }
+    }
+    return -1;
+}
+
+void CameraRegistry::clearObjects() {
+    for (auto &camera : mCameras) {
+        camera.instBatch.clear();
+    }
+}
+
+void CameraRegistry::addObject(
+    int classId,
+    int trackId,
+    const std::array<float, 3> &xyz,
+    const std::array<float, 3> &lwh,
+    float yaw) {
+    for (auto &camera : mCameras) {
+        camera.instBatch.add(classId, trackId, xyz, lwh, yaw);
+    }
+}
+
+void CameraRegistry::setAnnotation(bool enable) {
+    for (auto &camera : mCameras) {
+        camera.instBatch.setAnnotation(enable);
+    }
+}
+
+RejectCounts CameraRegistry::rejectCounts() const {
+    RejectCounts total{};
+    for (const auto &camera : mCameras) {
+        const RejectCounts counts = camera.instBatch.rejectCounts();
+        for (int i = 0; i < kNumRejectReasons; ++i) {
+            total[i] += counts[i];
+        }
+    }
+    return total;
+}
+
+void CameraRegistry::project(const std::vector<cv::Mat> &imgs, WorkerPool &workers) {
+    if (static_cast<int>(imgs.size()) != size()) {
+        std::cout << "CameraRegistry: " << imgs.size() << " images for " << size() << " cameras"
+                  << std::endl;
+        exit(1);
+    }
+
+    auto projectCamera = [this, &imgs](int cameraIdx) {
+        Camera &camera = mCameras[cameraIdx];
+        const cv::Mat &img = imgs[cameraIdx];
+        camera.instBatch.project(camera.calib, img.rows, img.cols);
+        camera.occMask->reset(img.rows, img.cols);
+    };
+
+    // camera 하나면 pool을 거치지 않고 바로 계산.
+    if (size() == 1) {
+        projectCamera(0);
+    } else {
+        workers.parallelFor(size(), projectCamera);
+    }
+
+    route();
+}
+
+/*
+ * object마다 tail을 인식할 camera 선택.
+ * 1. tail corner가 모두 이미지 안에 있는 camera 우선
+ * 2. 그 중 tail을 가장 정면에서 보는 (yawByView가 작은) camera
+ * camera가 하나면 projection이 유효한 모든 object를 담당한다.
+ */
+void CameraRegistry::route() {
+    const int numObjects = size() > 0 ? mCameras[0].instBatch.size() : 0;
+    for (auto &camera : mCameras) {
+        camera.routed.assign(numObjects, 0);
+    }
+
+    for (int idx = 0; idx < numObjects; ++idx) {
+        int bestCamera = -1;
+        bool bestTailInImage = false;
+        float bestYawByView = std::numeric_limits<float>::infinity();
+        for (int cameraIdx = 0; cameraIdx < size(); ++cameraIdx) {
+            const InstanceBatch &instBatch = mCameras[cameraIdx].instBatch;
+            if (!instBatch.isValidProjection(idx)) {
+                continue;
+            }
+            const bool tailInImage = instBatch.isTailInImage(idx);
+            const float yawByView = instBatch.yawByView(idx);
+            if (bestCamera < 0 || (tailInImage && !bestTailInImage) ||
+                (tailInImage == bestTailInImage && yawByView < bestYawByView)) {
+                bestCamera = cameraIdx;
+                bestTailInImage = tailInImage;
+                bestYawByView = yawByView;
+            }
+        }
+        if (bestCamera >= 0) {
+            mCameras[bestCamera].routed[idx] = 1;
+        }
+    }
+}
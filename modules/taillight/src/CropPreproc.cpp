@@ -0,0 +1,150 @@
+#include "taillight/CropPreproc.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// cv::resize(INTER_LINEAR)의 source 좌표. 양 끝은 edge pixel로 clamp.
+inline void sourceCoord(int dstIdx, float ratio, int srcLen, int &idx0, int &idx1, float &w) {
+    float src = (dstIdx + 0.5f) * ratio - 0.5f;
+    int idx = static_cast<int>(std::floor(src));
+    w = src - idx;
+    if (idx < 0) {
+        idx = 0;
+        w = 0.0f;
+    }
+    if (idx >= srcLen - 1) {
+        idx = srcLen - 1;
+        w = 0.0f;
+    }
+    idx0 = idx;
+    idx1 = std::min(idx + 1, srcLen - 1);
+}
+
+// 모든 output type이 공유하는 sampling loop. store(value, channel)이 최종 값을 만든다.
+template <typename T, typename Store>
+void resizeInto(
+    const cv::Mat &img,
+    const cv::Rect &srcRoi,
+    const CropPreproc::Params &params,
+    T *dst,
+    Store store) {
+    const int outH = params.outH;
+    const int outW = params.outW;
+
+    // layout별 stride. (pixel 간, channel 간)
+    const int planeSize = outH * outW;
+    const int pixelStride = params.layout == CropPreproc::Layout::kNHWC ? 3 : 1;
+    const int channelStride = params.layout == CropPreproc::Layout::kNHWC ? 1 : planeSize;
+
+    // output channel c = source channel srcChannel[c]
+    int srcChannel[3];
+    for (int c = 0; c < 3; ++c) {
+        srcChannel[c] = params.swapRB ? 2 - c : c;
+    }
+
+    // column별 sampling 위치는 모든 row에서 같으므로 미리 계산.
+    // (thread마다 유지되어 호출마다 할당하지 않는다.)
+    thread_local std::vector<int> xOfs0;
+    thread_local std::vector<int> xOfs1;
+    thread_local std::vector<float> xWeights;
+    xOfs0.resize(outW);
+    xOfs1.resize(outW);
+    xWeights.resize(outW);
+    const float ratioX = static_cast<float>(srcRoi.width) / outW;
+    for (int dx = 0; dx < outW; ++dx) {
+        int x0, x1;
+        sourceCoord(dx, ratioX, srcRoi.width, x0, x1, xWeights[dx]);
+        xOfs0[dx] = 3 * (srcRoi.x + x0);
+        xOfs1[dx] = 3 * (srcRoi.x + x1);
+    }
+
+    const float ratioY = static_cast<float>(srcRoi.height) / outH;
+    for (int dy = 0; dy < outH; ++dy) {
+        int y0, y1;
+        float wy;
+        sourceCoord(dy, ratioY, srcRoi.height, y0, y1, wy);
+        const uint8_t *row0 = img.ptr<uint8_t>(srcRoi.y + y0);
+        const uint8_t *row1 = img.ptr<uint8_t>(srcRoi.y + y1);
+
+        T *dstRow = dst + static_cast<size_t>(dy) * outW * pixelStride;
+        for (int dx = 0; dx < outW; ++dx) {
+            const float wx = xWeights[dx];
+            const uint8_t *p00 = row0 + xOfs0[dx];
+            const uint8_t *p01 = row0 + xOfs1[dx];
+            const uint8_t *p10 = row1 + xOfs0[dx];
+            const uint8_t *p11 = row1 + xOfs1[dx];
+
+            T *dstPixel = dstRow + dx * pixelStride;
+            for (int c = 0; c < 3; ++c) {
+                const int sc = srcChannel[c];
+                const float top = p00[sc] + wx * (p01[sc] - p00[sc]);
+                const float bottom = p10[sc] + wx * (p11[sc] - p10[sc]);
+                dstPixel[c * channelStride] = store(top + wy * (bottom - top), c);
+            }
+        }
+    }
+}
+
+} // namespace
+
+namespace CropPreproc {
+
+void cropResize(const cv::Mat &img, const cv::Rect &roi, const Params &params, void *dst) {
+    if (img.type() != CV_8UC3) {
+        std::cout << "Invalid cv::Mat type" << std::endl;
+        exit(1);
+    }
+
+    const cv::Rect srcRoi = roi & cv::Rect{0, 0, img.cols, img.rows};
+    if (srcRoi.empty()) {
+        std::memset(dst, 0, static_cast<size_t>(params.numEl()) * params.elemSize());
+        return;
+    }
+
+    switch (params.outType) {
+    case OutType::kFloat32: {
+        // 값은 x * alpha[c] + beta[c]
+        float alpha[3];
+        float beta[3];
+        for (int c = 0; c < 3; ++c) {
+            alpha[c] = params.scale[c];
+            beta[c] = -params.mean[c] * params.scale[c];
+        }
+        resizeInto(img, srcRoi, params, static_cast<float *>(dst), [&](float value, int c) {
+            return value * alpha[c] + beta[c];
+        });
+        return;
+    }
+    case OutType::kUInt8:
+        resizeInto(img, srcRoi, params, static_cast<uint8_t *>(dst), [](float value, int) {
+            return static_cast<uint8_t>(value + 0.5f);
+        });
+        return;
+    case OutType::kInt8:
+        // engine의 dynamic range (InputAdapter::kInt8RangeMin ~ Max) 밖인 -128은 쓰지 않는다.
+        resizeInto(img, srcRoi, params, static_cast<int8_t *>(dst), [](float value, int) {
+            return static_cast<int8_t>(std::max(static_cast<int>(value + 0.5f) - 128, -127));
+        });
+        return;
+    }
+}
+
+Params
+paramsFor(int outH, int outW, nvinfer1::DataType inputType, const InputAdapter::Spec &spec) {
+    Params params{outH, outW};
+    if (inputType == nvinfer1::DataType::kFLOAT) {
+        params.swapRB = spec.swapRB;
+        params.mean = spec.mean;
+        params.scale = spec.scale;
+    } else {
+        params.outType = inputType == nvinfer1::DataType::kINT8 ? OutType::kInt8 : OutType::kUInt8;
+        params.swapRB = false;
+    }
+    return params;
+}
+
+} // namespace CropPreproc
@@ -0,0 +1,150 @@
+#include "taillight/InstanceBatch.hpp"
+#include <algorithm>
+
+namespace {
+// box corner의 부호. 0 ~ 3: tail (x < 0), 4 ~ 7: front
+typedef Eigen::Array<float, 8, 1> Array8f;
+const Array8f kSignX = (Array8f() << -1, -1, -1, -1, 1, 1, 1, 1).finished();
+const Array8f kSignY = (Array8f() << -1, -1, 1, 1, -1, -1, 1, 1).finished();
+const Array8f kSignZ = (Array8f() << -1, 1, -1, 1, -1, 1, -1, 1).finished();
+} // namespace
+
+void InstanceBatch::reserve(int capacity) {
+    mClassIds.reserve(capacity);
+    mTrackIds.reserve(capacity);
+    mCenters.reserve(3 * capacity);
+    mSizes.reserve(3 * capacity);
+    mYaws.reserve(capacity);
+    mAnnotations.reserve(capacity);
+
+    if (mCornersX.cols() >= capacity) {
+        return;
+    }
+    mCornersX.resize(8, capacity);
+    mCornersY.resize(8, capacity);
+    mCornersZ.resize(8, capacity);
+    mCornersCamZ.resize(8, capacity);
+    mCornersU.resize(8, capacity);
+    mCornersV.resize(8, capacity);
+    mTailRange.resize(4, capacity);
+    mBoxRange.resize(4, capacity);
+    mDists.resize(capacity);
+    mYawByViews.resize(capacity);
+    mValidProjs.resize(capacity);
+    mTailInImages.resize(capacity);
+}
+
+void InstanceBatch::clear() {
+    mClassIds.clear();
+    mTrackIds.clear();
+    mCenters.clear();
+    mSizes.clear();
+    mYaws.clear();
+    mAnnotations.clear();
+}
+
+void InstanceBatch::add(
+    int classId,
+    int trackId,
+    const std::array<float, 3> &xyz,
+    const std::array<float, 3> &lwh,
+    float yaw) {
+    mClassIds.push_back(classId);
+    mTrackIds.push_back(trackId);
+    mCenters.insert(mCenters.end(), xyz.begin(), xyz.end());
+    mSizes.insert(mSizes.end(), lwh.begin(), lwh.end());
+    mYaws.push_back(yaw);
+    mAnnotations.emplace_back();
+}
+
+void InstanceBatch::project(const CalibParams &calib_params, int imgH, int imgW) {
+    const int N = size();
+    reserve(N);
+    mImgH = imgH;
+    mImgW = imgW;
+    mRejectCounts.fill(0);
+
+    /* ----------------------------------*
+     * Set corners (vehicle coordinate)
+     * ----------------------------------*/
+    for (int i = 0; i < N; ++i) {
+        const float c = std::cos(mYaws[i]);
+        const float s = std::sin(mYaws[i]);
+        const Array8f halfL = kSignX * (0.5f * mSizes[3 * i]);
+        const Array8f halfW = kSignY * (0.5f * mSizes[3 * i + 1]);
+        const Array8f halfH = kSignZ * (0.5f * mSizes[3 * i + 2]);
+
+        mCornersX.col(i) = mCenters[3 * i] + c * halfL - s * halfW;
+        mCornersY.col(i) = mCenters[3 * i + 1] + s * halfL + c * halfW;
+        mCornersZ.col(i) = mCenters[3 * i + 2] + halfH;
+    }
+
+    /* ------------------------------------------*
+     * Project all corners at once (P = K * T)
+     * ------------------------------------------*/
+    const auto X = mCornersX.leftCols(N);
+    const auto Y = mCornersY.leftCols(N);
+    const auto Z = mCornersZ.leftCols(N);
+    const Eigen::Matrix4f &T = calib_params.T_veh2cam;
+    const Eigen::Matrix<float, 3, 4> &P = calib_params.P_veh2img;
+
+    // T_veh2cam은 rigid transform (마지막 row = 0 0 0 1)
+    mCornersCamZ.leftCols(N) = T(2, 0) * X + T(2, 1) * Y + T(2, 2) * Z + T(2, 3);
+
+    const CornerArray depth = P(2, 0) * X + P(2, 1) * Y + P(2, 2) * Z + P(2, 3);
+    mCornersU.leftCols(N) = (P(0, 0) * X + P(0, 1) * Y + P(0, 2) * Z + P(0, 3)) / depth;
+    mCornersV.leftCols(N) = (P(1, 0) * X + P(1, 1) * Y + P(1, 2) * Z + P(1, 3)) / depth;
+
+    /* -------------------------------------------------*
+     * Minimun distance to box (roughly), culling, rect
+     * -------------------------------------------------*/
+    const auto U = mCornersU.leftCols(N);
+    const auto V = mCornersV.leftCols(N);
+    mDists.head(N) = (X.square() + Y.square()).sqrt().colwise().minCoeff().transpose();
+
+    const Eigen::Array<bool, 8, Eigen::Dynamic> inImage = U > 0 && U < imgW && V > 0 && V < imgH;
+    const Eigen::Array<bool, 1, Eigen::Dynamic> anyInImage = inImage.colwise().any();
+    const Eigen::Array<bool, 1, Eigen::Dynamic> allFront =
+        (mCornersCamZ.leftCols(N) > 0).colwise().all();
+    const Eigen::Array<bool, 1, Eigen::Dynamic> tailInImage =
+        inImage.topRows<4>().colwise().all();
+
+    mTailRange.row(0).head(N) = U.topRows<4>().colwise().minCoeff();
+    mTailRange.row(1).head(N) = U.topRows<4>().colwise().maxCoeff();
+    mTailRange.row(2).head(N) = V.topRows<4>().colwise().minCoeff();
+    mTailRange.row(3).head(N) = V.topRows<4>().colwise().maxCoeff();
+    mBoxRange.row(0).head(N) = U.colwise().minCoeff();
+    mBoxRange.row(1).head(N) = U.colwise().maxCoeff();
+    mBoxRange.row(2).head(N) = V.colwise().minCoeff();
+    mBoxRange.row(3).head(N) = V.colwise().maxCoeff();
+
+    /* ------------------------------------------------------*
+     * Tail view angle : tail 중심은 box 중심에서 -l/2 (x축)
+     * ------------------------------------------------------*/
+    for (int i = 0; i < N; ++i) {
+        mValidProjs[i] = anyInImage(i) && allFront(i);
+        mTailInImages[i] = tailInImage(i);
+
+        const float halfL = 0.5f * mSizes[3 * i];
+        const Eigen::Vector4f tailCenter{
+            mCenters[3 * i] - halfL * std::cos(mYaws[i]),
+            mCenters[3 * i + 1] - halfL * std::sin(mYaws[i]),
+            mCenters[3 * i + 2],
+            1.0f,
+        };
+        const float camX = T.row(0).dot(tailCenter);
+        const float camZ = T.row(2).dot(tailCenter);
+        const float viewAngleToTail = atan2(-camX, camZ);
+        mYawByViews(i) = abs(angleDiff(viewAngleToTail, mYaws[i]));
+    }
+}
+
+RejectCounts InstanceBatch::rejectCounts() const {
+    RejectCounts counts = mRejectCounts;
+    int evaluated = 0;
+    for (const int count : counts) {
+        evaluated += count;
+    }
+    counts[static_cast<int>(RejectReason::kNotEvaluated)] = size() - evaluated;
+    return counts;
+}
@@ -0,0 +1,21 @@
+#include "taillight/OcclusionMap.hpp"
+#include "taillight/OcclusionMask.hpp"
+#include "taillight/OcclusionRectUnion.hpp"
+#include "taillight/OcclusionRowPrefix.hpp"
+#include <iostream>
+
+std::unique_ptr<OcclusionMap> createOcclusionMap(const std::string &method) {
+    std::unique_ptr<OcclusionMap> occMap;
+    if (method == "bitmask") {
+        occMap = std::make_unique<OcclusionMask>();
+    } else if (method == "row_prefix") {
+        occMap = std::make_unique<OcclusionRowPrefix>();
+    } else if (method == "rect_union") {
+        occMap = std::make_unique<OcclusionRectUnion>();
+    } else {
+        std::cout << "Invalid occlusion method: " << method << " (bitmask, row_prefix, rect_union)"
+                  << std::endl;
+        exit(1);
+    }
+    return occMap;
+}
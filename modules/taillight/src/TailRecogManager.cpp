@@ -1,68 +1,150 @@
 #include "taillight/TailRecogManager.hpp"
-#include "infer-agents/CNN3DInferAgent.hpp"
-#include "infer-agents/RegressInferAgent.hpp"
-#include "infer-agents/UNetInferAgent.hpp"
+#include "TrackerCheckpoint.hpp"
+#include "infer-agents/AgentSpecs.hpp"
 
-TailRecogManager::TailRecogManager() {
-    const std::string homeDir = std::getenv("HOME");
-    InferenceParams params;
+TailRecogManager::TailRecogManager(
+    const TrackerParams &trackerParams,
+    const InferBackendParams &backendParams)
+    : mTrackerParams(trackerParams),
+      // track마다 최대 inSeqLen개의 slot을 참조하고, association 중 새 embedding이
+      // track에 넘어가기 전까지 1개의 slot이 추가로 필요하다.
+      mEmbPool(
+          ENCODED_TAIL_SIZE,
+          trackerParams.featStorage,
+          CNN3DCfg::inSeqLen,
+          trackerParams.maxTracks * CNN3DCfg::inSeqLen + 1),
+      mTrackIndex(trackerParams.maxTracks),
+      mCheckpoint(std::make_unique<TrackerCheckpoint>()),
+      mPreprocPool(trackerParams.preprocWorkers) {
+    mTrackedInsts.reserve(mTrackerParams.maxTracks);
+    mTrackMatched.reserve(mTrackerParams.maxTracks);
+    mSchedCandidates.reserve(mTrackerParams.maxTracks);
+    std::cout << "track pool: " << mTrackerParams.maxTracks << " tracks, "
+              << mEmbPool.numSlots() << " embedding slots, "
+              << mEmbPool.nbBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+    std::cout << "preprocess workers: " << mPreprocPool.numWorkers() << std::endl;
 
-    params.trtFilePath =
-        homeDir + "/Projects/ETRI_TailLightRecognition/scripts/onnx/Output/tail_det.trt";
-    mRegressAgent = std::make_unique<RegressInferAgent>(params);
+    std::string engineDir = backendParams.engineDir;
+    if (engineDir.empty()) {
+        const char *homeDir = std::getenv("HOME");
+        engineDir = std::string(homeDir ? homeDir : "") +
+                    "/Projects/ETRI_TailLightRecognition/scripts/onnx/Output";
+    }
+    std::cout << "inference backend: " << inferBackendName(backendParams.type);
+    if (!backendParams.recordDir.empty()) {
+        std::cout << " (record: " << backendParams.recordDir << ")";
+    }
+    std::cout << std::endl;
+
+    // engineName: .trt / 기록 파일 이름
+    auto paramsFor = [&](const std::string &engineName) {
+        InferenceParams params;
+        params.backend = backendParams.type;
+        params.trtFilePath = engineDir + "/" + engineName + ".trt";
+        if (!backendParams.recordDir.empty()) {
+            params.recordPath = backendParams.recordDir + "/" + engineName + ".inflog";
+        }
+        params.replayPath = backendParams.replayDir + "/" + engineName + ".inflog";
+        params.replayMatch = backendParams.replayMatch;
+        params.cpuImageInputType = backendParams.cpuByteInput ? InputAdapter::byteInputType()
+                                                              : nvinfer1::DataType::kFLOAT;
+        auto latency = backendParams.latencyModels.find(engineName);
+        if (latency != backendParams.latencyModels.end()) {
+            params.simulateLatency = true;
+            params.latencyModel = latency->second;
+            params.latencySpin = backendParams.latencySpin;
+            std::cout << "latency model (" << engineName << "): " << latency->second.fixedMs
+                      << " ms + " << latency->second.perItemMs << " ms / item, "
+                      << latency->second.copyGBps << " GB/s" << std::endl;
+        }
+        return params;
+    };
 
-    params.trtFilePath =
-        homeDir + "/Projects/ETRI_TailLightRecognition/scripts/onnx/Output/taillight_unet.trt";
-    mUNetAgent = std::make_unique<UNetInferAgent>(params);
+    mRegressAgent = std::make_unique<RegressInferAgent>(paramsFor("tail_det"));
+    mUNetAgent = std::make_unique<UNetInferAgent>(paramsFor("taillight_unet"));
+    mInferAgent = std::make_unique<CNN3DInferAgent>(paramsFor("taillight_3Dconv"));
 
-    params.trtFilePath =
-        homeDir + "/Projects/ETRI_TailLightRecognition/scripts/onnx/Output/taillight_3Dconv.trt";
-    mInferAgent = std::make_unique<CNN3DInferAgent>(params);
+    // engine이 받는 input type (float / byte)에 맞춰 preprocess 설정.
+    mRegPreproc =
+        CropPreproc::paramsFor(RegCfg::inH, RegCfg::inW, mRegressAgent->inputType(), mInputSpec);
+    mUNetPreproc =
+        CropPreproc::paramsFor(UNetCfg::inH, UNetCfg::inW, mUNetAgent->inputType(), mInputSpec);
+    std::cout << "input type (regress, unet): " << getTypeSize(mRegressAgent->inputType())
+              << " byte, " << getTypeSize(mUNetAgent->inputType()) << " byte" << std::endl;
 }
 
 TailRecogManager::~TailRecogManager() = default;
 
-std::map<int, cv::Rect>
-TailRecogManager::updateDet(cv::Mat img, std::vector<Instance> &instVec, ArrayXXb &occMask) {
-    // image 내에 약간이라도 projection되는 instance만 남김.
-    instVec.erase(
-        std::remove_if(
-            instVec.begin(),
-            instVec.end(),
-            [&img](auto x) { return !x.isValidProjection(img.rows, img.cols); }),
-        instVec.end());
-
-    // Sorting instVec by distance
-    std::sort(instVec.begin(), instVec.end(), [](const Instance &lhs, const Instance &rhs) {
-        return lhs.dist() < rhs.dist();
-    });
+std::map<int, TailRoi>
+TailRecogManager::updateDet(const std::vector<cv::Mat> &imgs, CameraRegistry &cameras) {
+    // 가림이 없는 tail view를 가지는 instances 추출. (camera, instance)
+    struct TailCandidate {
+        int cameraIdx;
+        Instance inst;
+    };
+    std::vector<TailCandidate> validTailInsts;
+
+    std::vector<int> instIdxs;
+    for (int cameraIdx = 0; cameraIdx < cameras.size(); ++cameraIdx) {
+        const CameraRegistry::Camera &camera = cameras[cameraIdx];
+        const InstanceBatch &instBatch = camera.instBatch;
+
+        // image 내에 약간이라도 projection되는 instance만 남김.
+        // (instBatch.project()에서 계산된 culling 결과. instance는 batch index로만 다룬다.)
+        instIdxs.clear();
+        for (int idx = 0; idx < instBatch.size(); ++idx) {
+            if (instBatch.isValidProjection(idx)) {
+                instIdxs.push_back(idx);
+            }
+        }
+
+        // Sorting by distance
+        std::sort(instIdxs.begin(), instIdxs.end(), [&instBatch](int lhs, int rhs) {
+            return instBatch.dist(lhs) < instBatch.dist(rhs);
+        });
 
-    // 가림이 없는 tail view를 가지는 instances 추출.
-    // 가까이 있는 instance부터 occMask에 projection 해나간다.
-    std::vector<Instance> validTailInsts;
-    for (const auto &eachInst : instVec) {
-        if (eachInst.isTailInSight(img.rows, img.cols, occMask)) {
-            validTailInsts.push_back(eachInst);
+        // 가까이 있는 instance부터 camera의 occMask에 projection 해나간다.
+        // tail은 이 camera로 routing 된 instance만 인식하고, 나머지는 occluder로만 사용.
+        for (const int idx : instIdxs) {
+            const Instance eachInst = instBatch[idx];
+            if (camera.routed[idx] &&
+                eachInst.isTailInSight(*camera.occMask, cameras.isSilhouette())) {
+                validTailInsts.push_back(TailCandidate{cameraIdx, eachInst});
+            }
+            if (cameras.isSilhouette()) {
+                eachInst.fillSilhouette(*camera.occMask);
+            } else {
+                auto [u_min, v_min, boxW, boxH] = eachInst.getBoundingRect();
+                camera.occMask->fill(v_min, u_min, boxH, boxW);
+            }
         }
-        auto [u_min, v_min, boxW, boxH] = eachInst.getBoundingRect(img.rows, img.cols);
-        occMask.block(v_min, u_min, boxH, boxW) = true;
     }
 
-    // tail crop image들을 모아서 tensorrt inference
+    // batch가 넘치면 가까운 instance 우선. (camera가 하나면 이미 거리 순서)
+    std::stable_sort(
+        validTailInsts.begin(),
+        validTailInsts.end(),
+        [](const TailCandidate &lhs, const TailCandidate &rhs) {
+            return lhs.inst.dist() < rhs.inst.dist();
+        });
+
+    // tail crop을 Regress input buffer의 batch slot에 바로 preprocess 하여 tensorrt inference
+    // (crop, resize, BGR -> RGB, (0~255) -> (0~1)을 한 번에)
+    // crop마다 서로 다른 slot에 쓰므로 worker pool에서 나누어 실행해도 결과는 같다.
+    const int numTails = std::min(static_cast<int>(validTailInsts.size()), RegCfg::inB);
     std::vector<cv::Rect> croppedRois;
-    std::vector<cv::Mat> croppedImgs;
-    for (auto &inst : validTailInsts) {
-        auto [tailU, tailV, tailW, tailH] = inst.getTailRect(img.rows, img.cols, 0.5);
-        cv::Rect roi{tailU, tailV, tailW, tailH};
-        croppedRois.push_back(roi);
-        cv::Mat croppedImg = img(roi);
-        cv::resize(croppedImg, croppedImg, cv::Size{RegCfg::inW, RegCfg::inH});
-        cv::cvtColor(croppedImg, croppedImg, cv::COLOR_BGR2RGB);
-        croppedImg.convertTo(croppedImg, CV_32FC3);
-        croppedImg = croppedImg / 255.0f; // (0~255) -> (0~1)
-        croppedImgs.push_back(croppedImg);
-    }
-    std::vector<std::array<float, 4>> regressCoords = mRegressAgent->infer(croppedImgs);
+    for (int i = 0; i < numTails; ++i) {
+        auto [tailU, tailV, tailW, tailH] = validTailInsts[i].inst.getTailRect(0.5);
+        croppedRois.emplace_back(tailU, tailV, tailW, tailH);
+    }
+    mPreprocPool.parallelFor(numTails, [&](int i) {
+        CropPreproc::cropResize(
+            imgs[validTailInsts[i].cameraIdx],
+            croppedRois[i],
+            mRegPreproc,
+            mRegressAgent->inputSlot(i));
+    });
+    std::vector<std::array<float, 4>> regressCoords = mRegressAgent->infer(numTails);
 
     // Collect RegressedRois
     std::vector<cv::Rect> regressedRois;
@@ -76,38 +158,24 @@ TailRecogManager::updateDet(cv::Mat img, std::vector<Instance> &instVec, ArrayXX
         regressedRois.push_back(regressedRoi);
     }
 
-    // Collect Regressed Imgs
-    std::vector<cv::Mat> regressedImgs;
-    for (const auto &eachRoi : regressedRois) {
-        cv::Mat regressedImg;
-        cv::resize(img(eachRoi), regressedImg, cv::Size{UNetCfg::inW, UNetCfg::inH});
-
-        cv::cvtColor(regressedImg, regressedImg, cv::COLOR_BGR2RGB);
-        regressedImg.convertTo(regressedImg, CV_32FC3);
-        regressedImg = regressedImg / 255.0f; // (0~255) -> (0~1)
-        regressedImgs.push_back(regressedImg);
-    }
+    // Regressed Imgs -> UNet input buffer
+    mPreprocPool.parallelFor(static_cast<int>(regressedRois.size()), [&](int i) {
+        CropPreproc::cropResize(
+            imgs[validTailInsts[i].cameraIdx],
+            regressedRois[i],
+            mUNetPreproc,
+            mUNetAgent->inputSlot(i));
+    });
     // unet inferece
-    std::vector<std::vector<float>> encodedImgs = mUNetAgent->infer(regressedImgs);
+    const int numEncoded = mUNetAgent->infer(static_cast<int>(regressedRois.size()));
 
     // Tracker Update
-    std::list<TrackerInput> trackerInputs;
-    for (size_t i = 0; i < encodedImgs.size(); ++i) {
-        trackerInputs.push_back(TrackerInput{validTailInsts[i].trackId(), encodedImgs[i]});
-    }
-
-    // Update tracked instances.
-    for (auto &elem : mTrackedInsts) {
-        elem.update(trackerInputs);
-    }
-
-    // Generate New instances
-    for (const auto &elem : trackerInputs) {
-        mTrackedInsts.emplace_back(elem);
+    std::vector<TrackerInput> trackerInputs;
+    for (int i = 0; i < numEncoded; ++i) {
+        trackerInputs.push_back(
+            TrackerInput{validTailInsts[i].inst.trackId(), i, validTailInsts[i].inst.dist()});
     }
-
-    // 최근 3프레임에 detect이 없으면 제거
-    mTrackedInsts.remove_if([](const TrackedInst &inst) { return inst.shouldRemoved(); });
+    associate(trackerInputs);
 
     // print
     for (const auto &elem : mTrackedInsts) {
@@ -115,35 +183,197 @@ TailRecogManager::updateDet(cv::Mat img, std::vector<Instance> &instVec, ArrayXX
     }
 
     // debugging용 return
-    std::map<int, cv::Rect> trackId_to_regressedRoi;
+    std::map<int, TailRoi> trackId_to_regressedRoi;
     for (size_t i = 0; i < regressedRois.size(); ++i) {
-        trackId_to_regressedRoi.emplace(validTailInsts[i].trackId(), regressedRois[i]);
+        trackId_to_regressedRoi.emplace(
+            validTailInsts[i].inst.trackId(),
+            TailRoi{validTailInsts[i].cameraIdx, regressedRois[i]});
     }
 
     return trackId_to_regressedRoi;
 }
 
+bool TailRecogManager::saveCheckpoint(const std::string &path) {
+    return mCheckpoint->saveAsync(path, mTrackedInsts, mEmbPool);
+}
+
+bool TailRecogManager::loadCheckpoint(const std::string &path, double maxAgeSec) {
+    if (!TrackerCheckpoint::load(
+            path, maxAgeSec, mTrackerParams.maxTracks, mEmbPool, mTrackedInsts)) {
+        return false;
+    }
+
+    reindexTracks();
+    return true;
+}
+
+void TailRecogManager::associate(const std::vector<TrackerInput> &inputs) {
+    ++mFrameIdx;
+
+    // 완료된 checkpoint 기록이 retain 하던 slot 해제.
+    mCheckpoint->poll();
+
+    const size_t numPrevTracks = mTrackedInsts.size();
+    mTrackMatched.assign(numPrevTracks, 0);
+
+    // 1. matched track은 update.
+    for (const auto &input : inputs) {
+        const int idx = mTrackIndex.find(input.trackId);
+        if (idx == FlatIdMap::kNotFound || mTrackMatched[idx]) {
+            continue; // 새 trackId 또는 중복된 trackId
+        }
+
+        const int poolSlot = storeEmbedding(input.embSlot);
+        mTrackedInsts[idx].update(poolSlot, input.dist);
+        mEmbPool.release(poolSlot); // store()의 참조 해제. 이제 track만 참조한다.
+        mTrackMatched[idx] = 1;
+    }
+
+    // 2. matched detection이 없는 기존 track은 aging.
+    for (size_t idx = 0; idx < numPrevTracks; ++idx) {
+        if (!mTrackMatched[idx]) {
+            mTrackedInsts[idx].updateMissed();
+        }
+    }
+
+    // 3. 최근 removeWindow 프레임에 detect이 없으면 제거. 남은 track의 순서는 유지된다.
+    const auto removedBegin = std::remove_if(
+        mTrackedInsts.begin(), mTrackedInsts.end(), [this](const TrackedInst &elem) {
+            return elem.shouldRemoved(mTrackerParams);
+        });
+    if (removedBegin != mTrackedInsts.end()) {
+        mTrackedInsts.erase(removedBegin, mTrackedInsts.end());
+        reindexTracks();
+    }
+
+    // 4. 새 trackId는 pool에 여유가 있거나 admission policy를 통과하면 생성.
+    //    inputs는 거리 순으로 정렬되어 있으므로 가까운 instance부터 admission 된다.
+    for (const auto &input : inputs) {
+        if (mTrackIndex.find(input.trackId) != FlatIdMap::kNotFound) {
+            continue;
+        }
+        if (!admitTrack(input)) {
+            continue;
+        }
+
+        const int poolSlot = storeEmbedding(input.embSlot);
+        mTrackIndex.insert(input.trackId, mTrackedInsts.size());
+        mTrackedInsts.emplace_back(input.trackId, poolSlot, input.dist, mFrameIdx, mEmbPool);
+        mEmbPool.release(poolSlot);
+    }
+}
+
+// embedding은 pool에 한 번만 encode 되고, 이후에는 slot 참조로만 공유된다.
+int TailRecogManager::storeEmbedding(int embSlot) {
+    // 기록 중인 checkpoint가 slot을 잡고 있어 pool이 부족하면 기록 완료를 기다린다.
+    if (mEmbPool.numFreeSlots() == 0) {
+        mCheckpoint->wait();
+    }
+    return mEmbPool.store(mUNetAgent->outputSlot(embSlot));
+}
+
+// pool이 가득 찼다면, 가장 먼 track보다 가까운 경우에만 그 track을 evict 하고 admission.
+bool TailRecogManager::admitTrack(const TrackerInput &input) {
+    if (static_cast<int>(mTrackedInsts.size()) < mTrackerParams.maxTracks) {
+        return true;
+    }
+    if (mTrackedInsts.empty()) {
+        return false;
+    }
+
+    const auto farthest = std::max_element(
+        mTrackedInsts.begin(),
+        mTrackedInsts.end(),
+        [](const TrackedInst &lhs, const TrackedInst &rhs) { return lhs.dist() < rhs.dist(); });
+    if (input.dist >= farthest->dist()) {
+        return false;
+    }
+
+    removeTrack(farthest - mTrackedInsts.begin());
+    return true;
+}
+
+// 뒤쪽 track을 한 칸씩 당긴다. mTrackedInsts는 생성 순서를 유지하므로 run 간 비교가 가능하다.
+void TailRecogManager::removeTrack(size_t idx) {
+    mTrackedInsts.erase(mTrackedInsts.begin() + idx);
+    reindexTracks();
+}
+
+void TailRecogManager::reindexTracks() {
+    mTrackIndex.clear();
+    for (size_t idx = 0; idx < mTrackedInsts.size(); ++idx) {
+        mTrackIndex.insert(mTrackedInsts[idx].trackId(), idx);
+    }
+}
+
 std::map<int, int> TailRecogManager::infer() {
-    std::vector<std::vector<float>> inputFeats;
-    std::vector<int> inferredTrackIds;
-    for (const auto &elem : mTrackedInsts) {
-        if (elem.canInfered()) {
-            inputFeats.push_back(elem.getConcatedFeats());
-            inferredTrackIds.push_back(elem.trackId());
+    std::map<int, int> trackId_to_state;
+
+    // infer 할 차례인 track은 scheduling 후보로, 아닌 track은 cache 된 state를 그대로 반환.
+    mSchedCandidates.clear();
+    for (size_t idx = 0; idx < mTrackedInsts.size(); ++idx) {
+        const TrackedInst &elem = mTrackedInsts[idx];
+        if (!elem.canInfered(mTrackerParams)) {
+            continue;
+        }
+
+        if (elem.isInferDue(mFrameIdx, mTrackerParams.inferStride)) {
+            mSchedCandidates.emplace_back(
+                elem.schedPriority(mFrameIdx, mTrackerParams.schedDistWeight), idx);
+        }
+        if (elem.hasCachedState()) {
+            trackId_to_state.emplace(elem.trackId(), elem.cachedState());
         }
     }
-    std::vector<int> inferredStates = mInferAgent->infer(inputFeats);
 
-    if ((inferredTrackIds.size() != inferredStates.size()) &&
-        (inferredTrackIds.size() <= CNN3DCfg::inB)) {
+    // 우선순위가 높은 순서로 batch slot을 채운다. (동점이면 가까운 track, 낮은 trackId 순)
+    const size_t realB = std::min(mSchedCandidates.size(), static_cast<size_t>(CNN3DCfg::inB));
+    std::partial_sort(
+        mSchedCandidates.begin(),
+        mSchedCandidates.begin() + realB,
+        mSchedCandidates.end(),
+        [this](const std::pair<float, size_t> &lhs, const std::pair<float, size_t> &rhs) {
+            if (lhs.first != rhs.first) {
+                return lhs.first > rhs.first;
+            }
+            const TrackedInst &l = mTrackedInsts[lhs.second];
+            const TrackedInst &r = mTrackedInsts[rhs.second];
+            if (l.dist() != r.dist()) {
+                return l.dist() < r.dist();
+            }
+            return l.trackId() < r.trackId();
+        });
+
+    // 선택된 track이 CNN3D staging buffer의 batch slot에 window를 직접 써넣는다.
+    for (size_t i = 0; i < realB; ++i) {
+        mTrackedInsts[mSchedCandidates[i].second].writeConcatedFeats(mInferAgent->inputSlot(i));
+    }
+    std::vector<int> inferredStates = mInferAgent->infer(realB);
+    std::cout << "result" << std::endl;
+    for (int state : inferredStates) {
+        std::cout << state << std::endl;
+    }
+
+    if (realB != inferredStates.size()) {
         std::cout << "inferredTrackIds and inferredStates should have same size" << std::endl;
         exit(1);
     }
 
-    std::map<int, int> trackId_to_state;
-    for (size_t i = 0; i < inferredStates.size(); ++i) {
-        trackId_to_state.emplace(inferredTrackIds[i], inferredStates[i]);
+    for (size_t i = 0; i < realB; ++i) {
+        TrackedInst &elem = mTrackedInsts[mSchedCandidates[i].second];
+        elem.setInferResult(inferredStates[i], mFrameIdx);
+        trackId_to_state[elem.trackId()] = inferredStates[i];
     }
 
     return trackId_to_state;
 }
+
+std::map<int, int> TailRecogManager::getInferAges() const {
+    std::map<int, int> trackId_to_age;
+    for (const auto &elem : mTrackedInsts) {
+        trackId_to_age.emplace(
+            elem.trackId(),
+            elem.hasCachedState() ? static_cast<int>(elem.inferAge(mFrameIdx)) : -1);
+    }
+    return trackId_to_age;
+}
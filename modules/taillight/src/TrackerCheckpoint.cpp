@@ -0,0 +1,281 @@
+#include "TrackerCheckpoint.hpp"
+#include "taillight/FlatIdMap.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'L', 'C', 'K'};
+constexpr uint32_t kVersion = 1;
+
+struct CheckpointHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t storage; // FeatStorage
+    uint32_t frameSize;
+    uint32_t lenSeq;
+    uint32_t numSlots;
+    uint32_t numTracks;
+    uint32_t reserved;
+    int64_t createdAt; // unix time (sec)
+};
+
+int64_t unixTimeSec() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// background thread에서 실행. slotPtrs는 main thread가 retain 하고 있는 slot들.
+bool writeCheckpoint(
+    const std::string &path,
+    const CheckpointHeader &header,
+    const std::vector<int32_t> &trackRecords,
+    const std::vector<float> &scales,
+    const std::vector<const uint8_t *> &slotPtrs,
+    size_t encodedBytes) {
+
+    // 쓰는 도중 종료되어도 이전 snapshot이 깨지지 않도록 tmp에 쓰고 rename.
+    const std::string tmpPath = path + ".tmp";
+    std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+    if (ofs.fail()) {
+        std::cout << "Error opening checkpoint file: " << tmpPath << std::endl;
+        return false;
+    }
+
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    ofs.write(
+        reinterpret_cast<const char *>(trackRecords.data()),
+        trackRecords.size() * sizeof(int32_t));
+    ofs.write(reinterpret_cast<const char *>(scales.data()), scales.size() * sizeof(float));
+    for (const uint8_t *ptr : slotPtrs) {
+        ofs.write(reinterpret_cast<const char *>(ptr), encodedBytes);
+    }
+    ofs.close();
+    if (ofs.fail()) {
+        std::cout << "Error writing checkpoint file: " << tmpPath << std::endl;
+        return false;
+    }
+
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+} // namespace
+
+bool TrackerCheckpoint::saveAsync(
+    const std::string &path, const std::vector<TrackedInst> &tracks, EmbeddingPool &pool) {
+    poll();
+    if (mWriteDone.valid()) {
+        return false;
+    }
+
+    const int lenSeq = TrackedInst::lenSeq();
+
+    // pool slot -> snapshot slot index. 공유되는 slot은 한 번만 기록.
+    FlatIdMap slotIndex(tracks.size() * lenSeq);
+    std::vector<int32_t> trackRecords;
+    trackRecords.reserve(tracks.size() * (2 + lenSeq));
+    std::vector<float> scales;
+    std::vector<const uint8_t *> slotPtrs;
+
+    for (const auto &track : tracks) {
+        trackRecords.push_back(track.trackId());
+        trackRecords.push_back(static_cast<int32_t>(track.detectedBits()));
+        for (int t = 0; t < lenSeq; ++t) {
+            const int poolSlot = track.slotAt(t);
+            if (poolSlot == EmbeddingPool::kZeroSlot) {
+                trackRecords.push_back(-1);
+                continue;
+            }
+
+            int snapshotSlot = slotIndex.find(poolSlot);
+            if (snapshotSlot == FlatIdMap::kNotFound) {
+                snapshotSlot = static_cast<int>(slotPtrs.size());
+                slotIndex.insert(poolSlot, snapshotSlot);
+
+                pool.retain(poolSlot);
+                mRetainedSlots.push_back(poolSlot);
+                scales.push_back(pool.scale(poolSlot));
+                slotPtrs.push_back(pool.encodedData(poolSlot));
+            }
+            trackRecords.push_back(snapshotSlot);
+        }
+    }
+
+    CheckpointHeader header{};
+    std::copy(kMagic, kMagic + 4, header.magic);
+    header.version = kVersion;
+    header.storage = static_cast<uint32_t>(pool.storage());
+    header.frameSize = pool.frameSize();
+    header.lenSeq = lenSeq;
+    header.numSlots = slotPtrs.size();
+    header.numTracks = tracks.size();
+    header.createdAt = unixTimeSec();
+
+    mPool = &pool;
+    mWriteDone = std::async(
+        std::launch::async,
+        writeCheckpoint,
+        path,
+        header,
+        std::move(trackRecords),
+        std::move(scales),
+        std::move(slotPtrs),
+        pool.encodedBytes());
+    return true;
+}
+
+void TrackerCheckpoint::poll() {
+    if (!mWriteDone.valid() ||
+        mWriteDone.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    if (!mWriteDone.get()) {
+        std::cout << "Checkpoint write failed" << std::endl;
+    }
+    for (const int slot : mRetainedSlots) {
+        mPool->release(slot);
+    }
+    mRetainedSlots.clear();
+}
+
+void TrackerCheckpoint::wait() {
+    if (mWriteDone.valid()) {
+        mWriteDone.wait();
+    }
+    poll();
+}
+
+bool TrackerCheckpoint::load(
+    const std::string &path,
+    double maxAgeSec,
+    int maxTracks,
+    EmbeddingPool &pool,
+    std::vector<TrackedInst> &tracks) {
+
+    // 기존 track과 trackId가 겹치거나 maxTracks를 넘지 않도록 빈 tracker에만 복원한다.
+    if (!tracks.empty()) {
+        std::cout << "Checkpoint: tracker already has tracks" << std::endl;
+        return false;
+    }
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "No checkpoint: " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(CheckpointHeader))) {
+        std::cout << "Invalid checkpoint file" << std::endl;
+        close(fd);
+        return false;
+    }
+    const size_t fileSize = st.st_size;
+    void *mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cout << "Error mapping checkpoint file" << std::endl;
+        return false;
+    }
+    const uint8_t *base = static_cast<const uint8_t *>(mapped);
+
+    // ---------------
+    // Check header
+    // ---------------
+    CheckpointHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    const int lenSeq = TrackedInst::lenSeq();
+    const FeatStorage fileStorage = static_cast<FeatStorage>(header.storage);
+    const size_t fileEncodedBytes = static_cast<size_t>(header.frameSize) *
+                                    featElemSize(fileStorage);
+    const size_t recordSize = (2 + lenSeq) * sizeof(int32_t);
+    const size_t expectedSize = sizeof(header) + header.numTracks * recordSize +
+                                header.numSlots * (sizeof(float) + fileEncodedBytes);
+    const double age = static_cast<double>(unixTimeSec() - header.createdAt);
+
+    bool valid = true;
+    if (!std::equal(kMagic, kMagic + 4, header.magic) || header.version != kVersion ||
+        header.storage > static_cast<uint32_t>(FeatStorage::kINT8) || fileSize != expectedSize) {
+        std::cout << "Invalid checkpoint file" << std::endl;
+        valid = false;
+    } else if (
+        static_cast<int>(header.frameSize) != pool.frameSize() ||
+        static_cast<int>(header.lenSeq) != lenSeq) {
+        std::cout << "Checkpoint shape mismatch" << std::endl;
+        valid = false;
+    } else if (age > maxAgeSec) {
+        std::cout << "Checkpoint is too old (" << age << " sec)" << std::endl;
+        valid = false;
+    }
+    if (!valid) {
+        munmap(mapped, fileSize);
+        return false;
+    }
+
+    // ---------------------------------
+    // Restore tracks and their slots
+    // ---------------------------------
+    const uint8_t *recordPtr = base + sizeof(header);
+    const uint8_t *scalePtr = recordPtr + header.numTracks * recordSize;
+    const uint8_t *slotPtr = scalePtr + header.numSlots * sizeof(float);
+
+    // snapshot slot -> pool slot. 복원되는 track이 참조하는 slot만 pool에 올린다.
+    constexpr int kNotLoaded = -2;
+    std::vector<int> poolSlots(header.numSlots, kNotLoaded);
+    std::vector<float> decoded;
+    auto loadSlot = [&](uint32_t i) {
+        if (poolSlots[i] != kNotLoaded) {
+            return poolSlots[i];
+        }
+        float scale;
+        std::memcpy(&scale, scalePtr + i * sizeof(float), sizeof(float));
+        const uint8_t *encoded = slotPtr + i * fileEncodedBytes;
+
+        if (fileStorage == pool.storage()) {
+            poolSlots[i] = pool.storeEncoded(encoded, scale);
+        } else {
+            // storage 형식이 바뀐 경우 FP32를 거쳐 다시 encode.
+            decoded.resize(header.frameSize);
+            FeatCodec::decode(fileStorage, encoded, scale, decoded.data(), header.frameSize);
+            poolSlots[i] = pool.store(decoded.data());
+        }
+        return poolSlots[i];
+    };
+
+    const uint32_t numRestored = std::min(header.numTracks, static_cast<uint32_t>(maxTracks));
+    std::vector<int32_t> record(2 + lenSeq);
+    std::vector<int> window(lenSeq);
+    for (uint32_t i = 0; i < numRestored; ++i) {
+        std::memcpy(record.data(), recordPtr + i * recordSize, recordSize);
+        for (int t = 0; t < lenSeq; ++t) {
+            const int32_t snapshotSlot = record[2 + t];
+            if (snapshotSlot < 0 || snapshotSlot >= static_cast<int32_t>(header.numSlots)) {
+                window[t] = EmbeddingPool::kZeroSlot;
+            } else {
+                window[t] = loadSlot(snapshotSlot);
+            }
+        }
+        tracks.emplace_back(record[0], static_cast<uint32_t>(record[1]), window.data(), pool);
+    }
+
+    // store()의 참조 해제. 이제 track만 참조한다.
+    for (const int slot : poolSlots) {
+        if (slot != kNotLoaded) {
+            pool.release(slot);
+        }
+    }
+
+    munmap(mapped, fileSize);
+    std::cout << "Checkpoint restored: " << numRestored << " / " << header.numTracks
+              << " tracks (" << age << " sec old)" << std::endl;
+    return true;
+}
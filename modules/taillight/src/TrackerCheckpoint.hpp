@@ -0,0 +1,55 @@
+#pragma once
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include "taillight/EmbeddingPool.hpp"
+#include "taillight/TrackedInst.hpp"
+
+/*
+ * Tracker state (trackId, detection bitmask, embedding window)의 binary snapshot.
+ * 재시작 시 window를 복원하여 cold window (최소 8 프레임)를 기다리지 않도록 한다.
+ *
+ * File layout (native endian)
+ *   CheckpointHeader
+ *   track records : numTracks * { int32 trackId, uint32 detectedBits, int32 slots[lenSeq] }
+ *   slot scales   : numSlots * float
+ *   slot data     : numSlots * encodedBytes  (storage 형식 그대로)
+ * window의 slot index는 snapshot 내부 index이며, -1은 zero frame.
+ * 여러 frame / track이 공유하는 slot은 한 번만 기록된다.
+ */
+class TrackerCheckpoint {
+  public:
+    TrackerCheckpoint() = default;
+    TrackerCheckpoint(const TrackerCheckpoint &) = delete;
+    TrackerCheckpoint &operator=(const TrackerCheckpoint &) = delete;
+    ~TrackerCheckpoint() { wait(); }
+
+    // 현재 state를 background thread에서 path에 기록한다.
+    // 기록 중인 slot은 retain 해두므로 main thread는 기다리지 않고 tracker를 계속 update 한다.
+    // 이전 기록이 아직 진행 중이면 false.
+    bool saveAsync(
+        const std::string &path, const std::vector<TrackedInst> &tracks, EmbeddingPool &pool);
+
+    // 완료된 기록이 있으면 retain 했던 slot을 해제. main thread에서 호출해야 한다.
+    void poll();
+
+    // 진행 중인 기록이 끝날 때까지 기다린 후 poll.
+    void wait();
+
+    // path의 snapshot을 mmap으로 읽어 pool과 tracks를 복원한다. (최대 maxTracks개)
+    // tracks는 비어 있어야 한다. (아니면 false)
+    // maxAgeSec 보다 오래된 snapshot이나 shape이 맞지 않는 snapshot은 무시하고 false.
+    static bool load(
+        const std::string &path,
+        double maxAgeSec,
+        int maxTracks,
+        EmbeddingPool &pool,
+        std::vector<TrackedInst> &tracks);
+
+  private:
+    EmbeddingPool *mPool{nullptr};
+    std::vector<int> mRetainedSlots;
+    std::future<bool> mWriteDone;
+};
@@ -0,0 +1,79 @@
+#include "taillight/WorkerPool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int numWorkers) {
+    mThreads.reserve(std::max(numWorkers, 0));
+    for (int i = 0; i < numWorkers; ++i) {
+        mThreads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (auto &thread : mThreads) {
+        thread.join();
+    }
+}
+
+// 이전 작업에 늦게 참여한 worker는 남은 index가 없으므로 job을 호출하지 않는다.
+void WorkerPool::runIndices(const std::function<void(int)> *job, int n) {
+    for (int i = mNextIdx.fetch_add(1); i < n; i = mNextIdx.fetch_add(1)) {
+        (*job)(i);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mWake.wait(lock, [&] { return mStop || mGeneration != seenGeneration; });
+        if (mStop) {
+            return;
+        }
+        seenGeneration = mGeneration;
+        const std::function<void(int)> *job = mJob;
+        const int n = mJobSize;
+        ++mActive;
+
+        lock.unlock();
+        runIndices(job, n);
+        lock.lock();
+
+        if (--mActive == 0) {
+            mIdle.notify_all();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(int n, const std::function<void(int)> &fn) {
+    if (n <= 0) {
+        return;
+    }
+    if (mThreads.empty() || n == 1) {
+        for (int i = 0; i < n; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    {
+        // 이전 작업에 늦게 참여한 worker가 남아 있으면 index를 초기화하기 전에 기다린다.
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdle.wait(lock, [&] { return mActive == 0; });
+        mJob = &fn;
+        mJobSize = n;
+        mNextIdx.store(0);
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    runIndices(&fn, n);
+
+    // 모든 index가 할당되었으므로, 참여한 worker가 끝나면 완료.
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [&] { return mActive == 0; });
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "InferAgent.hpp"
+#include "taillight/common.hpp"
+
+/*
+ * model별 InferAgent Spec. (InferAgent.hpp 참고)
+ * model을 추가하려면 Spec과 alias를 추가한다.
+ */
+struct AgentSpecBase {
+    static constexpr int kNumClasses = 0;
+};
+
+// tail 영역 regress. image -> box (x1, y1, x2, y2), crop 기준 0 ~ 1
+struct RegressSpec : AgentSpecBase {
+    static constexpr auto inDims = RegCfg::inDims;
+    static constexpr auto outDims = RegCfg::outDims;
+    using InputElem = void;
+    using OutputElem = float;
+    using Result = std::array<float, 4>;
+
+    static Result decode(const float *out) { return {out[0], out[1], out[2], out[3]}; }
+};
+
+// tail image -> feature. 결과는 outputSlot()으로 참조. (복사 없음)
+struct UNetSpec : AgentSpecBase {
+    static constexpr auto inDims = UNetCfg::inDims;
+    static constexpr auto outDims = UNetCfg::outDims;
+    using InputElem = void;
+    using OutputElem = float;
+    using Result = void;
+};
+
+// feature sequence -> 점등 state (STATES index)
+struct CNN3DSpec : AgentSpecBase {
+    static constexpr auto inDims = CNN3DCfg::inDims;
+    static constexpr auto outDims = CNN3DCfg::outDims;
+    using InputElem = float;
+    using OutputElem = int32_t;
+    using Result = int;
+    static constexpr int kNumClasses = static_cast<int>(STATES.size());
+
+    static Result decode(const int32_t *out) { return out[0]; }
+};
+
+using RegressInferAgent = InferAgent<RegressSpec>;
+using UNetInferAgent = InferAgent<UNetSpec>;
+using CNN3DInferAgent = InferAgent<CNN3DSpec>;
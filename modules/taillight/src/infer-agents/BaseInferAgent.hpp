@@ -1,19 +1,34 @@
 #pragma once
-#include <fstream>
+#include <memory>
 
 #include <NvInfer.h>
-#include <NvOnnxParser.h>
-#include <cuda_runtime_api.h>
 
-#include "trt_utils/bufferManager.h"
+#include "CpuBackend.hpp"
+#include "InferBackend.hpp"
+#include "LatencyModelBackend.hpp"
+#include "RecordReplayBackend.hpp"
+#include "TrtBackend.hpp"
+#include "taillight/common.hpp"
+#include "trt_utils/inputAdapter.h"
 
 struct InferenceParams {
     std::string inputTensorName = "Input";
     std::string outputTensorName = "Output";
     std::string trtFilePath;
+    InferBackendType backend = InferBackendType::kTensorRT;
+    std::string recordPath; // 비어 있지 않으면 execute 기록 (RecordingBackend)
+    std::string replayPath; // kReplay가 읽는 기록
+    ReplayMatch replayMatch = ReplayMatch::kSequence;
+    // kCpu의 image input (Spec::InputElem void) type. float 또는 InputAdapter::byteInputType()
+    nvinfer1::DataType cpuImageInputType = nvinfer1::DataType::kFLOAT;
+    bool simulateLatency = false; // backend 호출을 latencyModel 만큼 지연 (LatencyModelBackend)
+    LatencyModel latencyModel;
+    bool latencySpin = false;
 };
 
-inline void checkDims(const nvinfer1::Dims &dims, std::vector<int> targetDims) {
+// targetDims: std::vector<int> 또는 std::array<int, N>
+template <typename TargetDims>
+void checkDims(const nvinfer1::Dims &dims, const TargetDims &targetDims) {
 
     if (dims.nbDims != static_cast<int>(targetDims.size())) {
         std::cout << "Improper nbDims" << std::endl;
@@ -29,50 +44,72 @@ inline void checkDims(const nvinfer1::Dims &dims, std::vector<int> targetDims) {
     }
 }
 
+// cpuTensors: CPU backend가 만들 binding. (TensorRT backend는 engine, replay는 기록의 binding 사용)
+inline std::unique_ptr<IInferBackend>
+createInferBackend(const InferenceParams &params, const std::vector<TensorSpec> &cpuTensors) {
+    std::unique_ptr<IInferBackend> backend;
+    switch (params.backend) {
+    case InferBackendType::kTensorRT:
+        backend = std::make_unique<TrtBackend>(params.trtFilePath);
+        break;
+    case InferBackendType::kCpu:
+        backend = std::make_unique<CpuBackend>(cpuTensors);
+        break;
+    case InferBackendType::kReplay:
+        backend = std::make_unique<ReplayBackend>(
+            params.replayPath, params.replayMatch == ReplayMatch::kDigest);
+        break;
+    }
+    if (!backend) {
+        std::cout << "Invalid inference backend" << std::endl;
+        exit(1);
+    }
+
+    if (params.simulateLatency) {
+        backend = std::make_unique<LatencyModelBackend>(
+            std::move(backend), params.latencyModel, params.latencySpin);
+    }
+    if (!params.recordPath.empty()) {
+        backend = std::make_unique<RecordingBackend>(std::move(backend), params.recordPath);
+    }
+    return backend;
+}
+
 class BaseInferAgent {
 
   public:
-    BaseInferAgent(const InferenceParams &params) : mParams(params) { loadEngine(); }
+    BaseInferAgent(const InferenceParams &params, const std::vector<TensorSpec> &cpuTensors)
+        : mParams(params), mBackend(createInferBackend(params, cpuTensors)) {}
+
+    // input binding의 data type. float 이거나 byte (trt_utils/inputAdapter.h의 engine)
+    nvinfer1::DataType inputType() const {
+        return mBackend->bindingType(mBackend->bindingIndex(mParams.inputTensorName));
+    }
 
-    void loadEngine() {
-        std::ifstream engineFile(mParams.trtFilePath, std::ios::binary);
-        if (engineFile.fail()) {
-            std::cout << "Error opening TRT file." << std::endl;
+  protected:
+    // float / byte input만 처리할 수 있다. 반환값은 element 크기.
+    int checkImageInputType() const {
+        const nvinfer1::DataType type = inputType();
+        if (type != nvinfer1::DataType::kFLOAT && !InputAdapter::isByteType(type)) {
+            std::cout << "Unsupported input type" << std::endl;
             exit(1);
         }
+        return getTypeSize(type);
+    }
 
-        engineFile.seekg(0, engineFile.end);
-        long int fsize = engineFile.tellg();
-        engineFile.seekg(0, engineFile.beg);
-
-        std::vector<char> engineData(fsize);
-        engineFile.read(engineData.data(), fsize);
-        if (engineFile.fail()) {
-            std::cout << "Error reading TRT file." << std::endl;
+    // tensorName binding의 shape 확인. 반환값은 binding index.
+    template <typename TargetDims>
+    int checkBinding(const std::string &tensorName, const TargetDims &targetDims) const {
+        const int tensorIdx = mBackend->bindingIndex(tensorName);
+        if (tensorIdx == -1) {
+            std::cout << "Wrong Tensor Name: " << tensorName << std::endl;
             exit(1);
         }
+        checkDims(mBackend->bindingDims(tensorIdx), targetDims);
+        return tensorIdx;
+    }
 
-        UniquePtrTRT<nvinfer1::IRuntime> runtime{nvinfer1::createInferRuntime(gLogger)};
-        // if (DLACore != -1) { runtime->setDLACore(DLACore); }
-        mEngine = std::shared_ptr<nvinfer1::ICudaEngine>(
-            runtime->deserializeCudaEngine(engineData.data(), fsize, nullptr),
-            InferDeleter());
-
-        // -----------------------
-        // Create buffer manager
-        // -----------------------
-        mBufManager = std::make_unique<BufferManager>(mEngine);
-
-        // ---------------
-        // Create context
-        // ---------------
-        mContext = UniquePtrTRT<nvinfer1::IExecutionContext>(mEngine->createExecutionContext());
-    };
-
-  protected:
     InferenceParams mParams;
 
-    std::unique_ptr<BufferManager> mBufManager{nullptr};
-    std::shared_ptr<nvinfer1::ICudaEngine> mEngine{nullptr};
-    UniquePtrTRT<nvinfer1::IExecutionContext> mContext{nullptr};
+    std::unique_ptr<IInferBackend> mBackend{nullptr};
 };
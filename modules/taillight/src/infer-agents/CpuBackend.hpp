@@ -0,0 +1,187 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "InferBackend.hpp"
+#include "trt_utils/common.h"
+#include "trt_utils/inputAdapter.h"
+#include "trt_utils/simdKernels.h"
+
+/*
+ * GPU 없이 pipeline (geometry, preprocess, tracker, batching)을 실행 / profiling 하기 위한
+ * CPU stand-in. model 연산은 하지 않고, spec의 shape / type 대로 결정적인 output을 만든다.
+ *
+ * output의 batch b는 첫 번째 input의 batch b에서 sampling 한 element 평균 m으로만 결정된다.
+ * byte image input은 engine 앞단의 변환 (spec.inputAdapter)을 emulate 한 값을 사용하므로
+ * 같은 crop이면 float input과 같은 output이 된다. (byte 반올림 오차 이내)
+ * u = 0.5 + 0.5 * tanh(m) (0 ~ 1)은 input에 대해 연속이고 |du| <= 0.5 * max|input 오차| 이므로,
+ * 작은 input 오차 (feature storage, byte input 등)는 output에도 그 이하의 오차로만 나타난다.
+ * 실수 output은 batch마다 0 ~ 1의 증가 수열 (i + u) / n 이므로
+ * regress output (x1, y1, x2, y2)는 항상 유효한 box가 된다.
+ * 정수 output은 (floor(u * numClasses) + i) % numClasses.
+ */
+class CpuBackend : public IInferBackend {
+
+  public:
+    CpuBackend(const std::vector<TensorSpec> &tensors) : mTensors(tensors) {
+        for (size_t i = 0; i < mTensors.size(); ++i) {
+            const TensorSpec &spec = mTensors[i];
+            if (spec.dims.empty()) {
+                std::cout << "CPU backend: tensor without batch axis (" << spec.name << ")"
+                          << std::endl;
+                exit(1);
+            }
+            if (spec.isInput && InputAdapter::isByteType(spec.type) && spec.dims.back() != 3) {
+                std::cout << "CPU backend: byte input must be NHWC with 3 channels (" << spec.name
+                          << ")" << std::endl;
+                exit(1);
+            }
+            if (spec.isInput && mSeedInput < 0) {
+                mSeedInput = static_cast<int>(i);
+            }
+            mBuffers.emplace_back(
+                static_cast<size_t>(volume(toDims(spec.dims))) * getTypeSize(spec.type), 0);
+        }
+        if (mSeedInput < 0) {
+            std::cout << "CPU backend: no input tensor" << std::endl;
+            exit(1);
+        }
+        mBatchSeeds.assign(mTensors[mSeedInput].dims[0], 0.5f);
+    }
+
+    const char *name() const override { return "cpu"; }
+
+    int numBindings() const override { return static_cast<int>(mTensors.size()); }
+    std::string bindingName(int bindingIdx) const override { return specAt(bindingIdx).name; }
+    int bindingIndex(const std::string &tensorName) const override {
+        for (size_t i = 0; i < mTensors.size(); ++i) {
+            if (mTensors[i].name == tensorName) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    nvinfer1::Dims bindingDims(int bindingIdx) const override {
+        return toDims(specAt(bindingIdx).dims);
+    }
+    nvinfer1::DataType bindingType(int bindingIdx) const override {
+        return specAt(bindingIdx).type;
+    }
+    bool bindingIsInput(int bindingIdx) const override { return specAt(bindingIdx).isInput; }
+
+    void setInput(const std::string &tensorName, const void *hostPtr) override {
+        std::vector<uint8_t> &buffer = mBuffers[checkedIndex(tensorName, true)];
+        std::memcpy(buffer.data(), hostPtr, buffer.size());
+    }
+    void getOutput(const std::string &tensorName, void *hostPtr) override {
+        const std::vector<uint8_t> &buffer = mBuffers[checkedIndex(tensorName, false)];
+        std::memcpy(hostPtr, buffer.data(), buffer.size());
+    }
+
+    void execute(int /*realB*/) override {
+        const TensorSpec &inputSpec = mTensors[mSeedInput];
+        const std::vector<uint8_t> &input = mBuffers[mSeedInput];
+        const size_t batchNumEl = input.size() / getTypeSize(inputSpec.type) / mBatchSeeds.size();
+        const size_t step = std::max<size_t>(1, batchNumEl / kSeedSamples);
+        for (size_t b = 0; b < mBatchSeeds.size(); ++b) {
+            double sum = 0.0;
+            size_t count = 0;
+            for (size_t i = b * batchNumEl; i < (b + 1) * batchNumEl; i += step, ++count) {
+                sum += InputAdapter::isByteType(inputSpec.type)
+                           ? InputAdapter::emulateAt(
+                                 inputSpec.inputAdapter, inputSpec.type, input.data(), i)
+                           : elementAt(inputSpec.type, input, i);
+            }
+            mBatchSeeds[b] = 0.5f + 0.5f * std::tanh(static_cast<float>(sum / count));
+        }
+
+        for (size_t i = 0; i < mTensors.size(); ++i) {
+            if (!mTensors[i].isInput) {
+                fillOutput(mTensors[i], mBuffers[i]);
+            }
+        }
+    }
+
+  private:
+    // batch seed에 사용하는 sampling element 수. 입력 크기와 무관하게 비용이 일정하다.
+    static constexpr size_t kSeedSamples = 4096;
+
+    static float elementAt(nvinfer1::DataType type, const std::vector<uint8_t> &buffer, size_t i) {
+        switch (type) {
+        case nvinfer1::DataType::kFLOAT:
+            return reinterpret_cast<const float *>(buffer.data())[i];
+        case nvinfer1::DataType::kHALF:
+            return SimdKernels::scalar::halfToFloat(
+                reinterpret_cast<const uint16_t *>(buffer.data())[i]);
+        case nvinfer1::DataType::kINT32:
+            return static_cast<float>(reinterpret_cast<const int32_t *>(buffer.data())[i]);
+        default: // bool (byte image input은 InputAdapter::emulateAt)
+            return static_cast<float>(buffer[i]);
+        }
+    }
+
+    const TensorSpec &specAt(int bindingIdx) const {
+        if (bindingIdx < 0 || bindingIdx >= static_cast<int>(mTensors.size())) {
+            std::cout << "Wrong Tensor Index" << std::endl;
+            exit(1);
+        }
+        return mTensors[bindingIdx];
+    }
+
+    int checkedIndex(const std::string &tensorName, bool isInput) const {
+        const int index = bindingIndex(tensorName);
+        if (index == -1) {
+            std::cout << "Wrong Tensor Name" << std::endl;
+            exit(1);
+        }
+        if (mTensors[index].isInput != isInput) {
+            std::cout << "Memcpy: Wrong Direction." << std::endl;
+            exit(1);
+        }
+        return index;
+    }
+
+    void fillOutput(const TensorSpec &spec, std::vector<uint8_t> &buffer) const {
+        const int outB = spec.dims[0];
+        const size_t eachNumEl = buffer.size() / getTypeSize(spec.type) / outB;
+
+        for (int b = 0; b < outB; ++b) {
+            const float u = mBatchSeeds[b % mBatchSeeds.size()];
+            const size_t offset = static_cast<size_t>(b) * eachNumEl;
+            for (size_t i = 0; i < eachNumEl; ++i) {
+                const float value = (i + u) / eachNumEl;
+                switch (spec.type) {
+                case nvinfer1::DataType::kFLOAT:
+                    reinterpret_cast<float *>(buffer.data())[offset + i] = value;
+                    break;
+                case nvinfer1::DataType::kHALF:
+                    reinterpret_cast<uint16_t *>(buffer.data())[offset + i] =
+                        SimdKernels::scalar::floatToHalf(value);
+                    break;
+                case nvinfer1::DataType::kINT32:
+                    reinterpret_cast<int32_t *>(buffer.data())[offset + i] =
+                        spec.numClasses > 0 ? classOf(u, spec.numClasses, i) : 0;
+                    break;
+                case nvinfer1::DataType::kBOOL:
+                    buffer[offset + i] = value >= 0.5f ? 1 : 0;
+                    break;
+                default: // byte
+                    buffer[offset + i] = static_cast<uint8_t>(value * 127.0f);
+                    break;
+                }
+            }
+        }
+    }
+
+    static int32_t classOf(float u, int numClasses, size_t i) {
+        const int base = std::min(static_cast<int>(u * numClasses), numClasses - 1);
+        return static_cast<int32_t>((base + i) % numClasses);
+    }
+
+    std::vector<TensorSpec> mTensors;
+    std::vector<std::vector<uint8_t>> mBuffers; // binding별 host buffer
+    int mSeedInput{-1};                         // output seed를 만드는 input binding
+    std::vector<float> mBatchSeeds;             // batch별 u
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include <type_traits>
+
+#include "BaseInferAgent.hpp"
+
+/*
+ * batch 단위 host staging buffer를 가지는 agent. model별 차이는 Spec이 정한다.
+ *
+ * Spec (AgentSpecs.hpp)
+ *   inDims, outDims : std::array<int, N> (constexpr, 첫 axis가 batch)
+ *   InputElem       : input element type. void면 image input (float 또는 byte, engine이 결정)
+ *   OutputElem      : output element type
+ *   Result          : batch 하나의 decode 결과. void면 decode 없이 outputSlot()으로 참조
+ *   decode()        : Result decode(const OutputElem *batchOut)
+ *   kNumClasses     : 정수 output의 값 범위 (CPU backend)
+ *
+ * slot 크기와 stride는 compile time 상수이다.
+ */
+template <typename Spec> class InferAgent : public BaseInferAgent {
+
+  public:
+    using InputElem = typename Spec::InputElem;
+    using OutputElem = typename Spec::OutputElem;
+    using Result = typename Spec::Result;
+    using InputPtr = std::conditional_t<std::is_void_v<InputElem>, void *, InputElem *>;
+
+    static constexpr int kInB = Spec::inDims[0];
+    static constexpr int kOutB = Spec::outDims[0];
+    static constexpr int kEachInNumEl = dimsVolume(Spec::inDims) / kInB;
+    static constexpr int kEachOutNumEl = dimsVolume(Spec::outDims) / kOutB;
+    static_assert(kInB == kOutB, "input / output batch must match");
+
+    InferAgent(const InferenceParams &params);
+
+    // batch slot의 host staging buffer. caller가 preprocess 된 input을 직접 써넣는다.
+    // image input (InputElem void)의 element type은 inputType() (float 또는 byte)을 따른다.
+    InputPtr inputSlot(int batchIdx);
+
+    // 앞쪽 realB개의 slot이 채워졌다고 가정하고 inference.
+    // Result가 void면 inference 된 batch 수, 아니면 batch별 decode 결과를 반환한다.
+    auto infer(int realB);
+
+    // 다음 infer 호출 전까지 유효.
+    const OutputElem *outputSlot(int batchIdx) const;
+
+  private:
+    // execute 후 inference 된 batch 수.
+    int run(int realB);
+
+    // frame마다 재할당하지 않도록 유지되는 staging (bytes) / output buffer.
+    std::vector<uint8_t> mHostInBuffer;
+    int mInElemSize{sizeof(float)};
+    std::vector<OutputElem> mHostOutBuffer;
+};
+
+template <typename Spec>
+InferAgent<Spec>::InferAgent(const InferenceParams &params)
+    : BaseInferAgent(
+          params,
+          {{params.inputTensorName,
+            std::vector<int>(Spec::inDims.begin(), Spec::inDims.end()),
+            std::is_void_v<InputElem> ? params.cpuImageInputType : nvinfer1::DataType::kFLOAT,
+            true},
+           {params.outputTensorName,
+            std::vector<int>(Spec::outDims.begin(), Spec::outDims.end()),
+            std::is_floating_point_v<OutputElem> ? nvinfer1::DataType::kFLOAT
+                                                 : nvinfer1::DataType::kINT32,
+            false,
+            Spec::kNumClasses}}) {
+    // ------------
+    // Check Dims
+    // ------------
+    const int inputTensorIdx = checkBinding(mParams.inputTensorName, Spec::inDims);
+    const int outputTensorIdx = checkBinding(mParams.outputTensorName, Spec::outDims);
+
+    // ------------
+    // Check Types
+    // ------------
+    if constexpr (std::is_void_v<InputElem>) {
+        mInElemSize = checkImageInputType();
+    } else {
+        mInElemSize = sizeof(InputElem);
+        if (getTypeSize(mBackend->bindingType(inputTensorIdx)) != mInElemSize) {
+            std::cout << "Unsupported input type" << std::endl;
+            exit(1);
+        }
+    }
+    if (getTypeSize(mBackend->bindingType(outputTensorIdx)) != sizeof(OutputElem)) {
+        std::cout << "Unsupported output type" << std::endl;
+        exit(1);
+    }
+
+    mHostInBuffer.assign(static_cast<size_t>(kInB) * kEachInNumEl * mInElemSize, 0);
+    mHostOutBuffer.assign(static_cast<size_t>(kOutB) * kEachOutNumEl, OutputElem{});
+}
+
+template <typename Spec>
+typename InferAgent<Spec>::InputPtr InferAgent<Spec>::inputSlot(int batchIdx) {
+    if (batchIdx < 0 || batchIdx >= kInB) {
+        std::cout << "Invalid batch index" << std::endl;
+        exit(1);
+    }
+    uint8_t *slot =
+        mHostInBuffer.data() + static_cast<size_t>(batchIdx) * kEachInNumEl * mInElemSize;
+    return static_cast<InputPtr>(static_cast<void *>(slot));
+}
+
+template <typename Spec>
+const typename Spec::OutputElem *InferAgent<Spec>::outputSlot(int batchIdx) const {
+    if (batchIdx < 0 || batchIdx >= kOutB) {
+        std::cout << "Invalid batch index" << std::endl;
+        exit(1);
+    }
+    return mHostOutBuffer.data() + static_cast<size_t>(batchIdx) * kEachOutNumEl;
+}
+
+template <typename Spec> auto InferAgent<Spec>::infer(int realB) {
+    const int numInferred = run(realB);
+    if constexpr (std::is_void_v<Result>) {
+        return numInferred;
+    } else {
+        std::vector<Result> result;
+        result.reserve(numInferred);
+        for (int i = 0; i < numInferred; ++i) {
+            result.push_back(Spec::decode(mHostOutBuffer.data() + i * kEachOutNumEl));
+        }
+        return result;
+    }
+}
+
+template <typename Spec> int InferAgent<Spec>::run(int realB) {
+    if (realB <= 0) {
+        return 0;
+    }
+    realB = std::min(realB, kInB);
+
+    // realB 이후의 slot에는 이전 frame의 input이 남아있지만,
+    // batch 간 독립이므로 결과에 영향을 주지 않는다.
+
+    // ----------
+    // Set input
+    // ----------
+    mBackend->setInput(mParams.inputTensorName, mHostInBuffer.data());
+
+    // --------
+    // Execute
+    // --------
+    mBackend->execute(realB);
+
+    // -----------
+    // Get output
+    // -----------
+    mBackend->getOutput(mParams.outputTensorName, mHostOutBuffer.data());
+
+    return realB;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <NvInfer.h>
+
+#include "trt_utils/inputAdapter.h"
+
+/*
+ * agent가 사용하는 inference 실행부. (tensor metadata, host buffer binding, execute)
+ * TensorRT engine (TrtBackend) 외에 GPU 없이 pipeline 전체를 돌리기 위한
+ * CPU stand-in (CpuBackend)이 있다.
+ * host buffer의 크기는 binding의 volume * type size bytes.
+ */
+class IInferBackend {
+
+  public:
+    virtual ~IInferBackend() = default;
+
+    virtual const char *name() const = 0;
+
+    // ----------------
+    // Tensor metadata
+    // ----------------
+    virtual int numBindings() const = 0;
+    virtual std::string bindingName(int bindingIdx) const = 0;
+    // 없는 tensor 이름이면 -1
+    virtual int bindingIndex(const std::string &tensorName) const = 0;
+    virtual nvinfer1::Dims bindingDims(int bindingIdx) const = 0;
+    virtual nvinfer1::DataType bindingType(int bindingIdx) const = 0;
+    virtual bool bindingIsInput(int bindingIdx) const = 0;
+
+    // --------
+    // Binding
+    // --------
+    // 다음 execute()에 사용할 input을 복사.
+    virtual void setInput(const std::string &tensorName, const void *hostPtr) = 0;
+    // 마지막 execute()의 output을 복사.
+    virtual void getOutput(const std::string &tensorName, void *hostPtr) = 0;
+
+    // ----------
+    // Execution
+    // ----------
+    // realB: 앞쪽의 유효한 batch 수. (static batch engine은 항상 전체 batch를 실행한다.)
+    virtual void execute(int realB) = 0;
+};
+
+// engine 없이 binding을 정의할 때 사용. (CpuBackend)
+struct TensorSpec {
+    std::string name;
+    std::vector<int> dims;
+    nvinfer1::DataType type = nvinfer1::DataType::kFLOAT;
+    bool isInput = false;
+    int numClasses = 0; // 정수 output의 값 범위 [0, numClasses)
+    // byte image input 앞에 engine이 가진 변환 (execBuildOnly의 prepend). CpuBackend가 emulate
+    InputAdapter::Spec inputAdapter{};
+};
+
+inline nvinfer1::Dims toDims(const std::vector<int> &dims) {
+    if (static_cast<int>(dims.size()) > nvinfer1::Dims::MAX_DIMS) {
+        std::cout << "Too many dims" << std::endl;
+        exit(1);
+    }
+    nvinfer1::Dims result;
+    result.nbDims = static_cast<int>(dims.size());
+    for (int i = 0; i < result.nbDims; ++i) {
+        result.d[i] = dims[i];
+    }
+    return result;
+}
+
+// host buffer의 64 bit digest. (record / replay 대조, CPU backend output seed)
+// maxWords > 0이면 8 byte word를 최대 maxWords개 균등 간격으로 sampling 하여 비용을 고정한다.
+inline uint64_t digestBytes(const void *data, size_t nbBytes, size_t maxWords = 0) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    const size_t numWords = nbBytes / sizeof(uint64_t);
+    const size_t step = maxWords > 0 ? std::max<size_t>(1, numWords / maxWords) : 1;
+
+    auto mix = [](uint64_t h, uint64_t word) {
+        h ^= word;
+        h *= 0x9e3779b97f4a7c15ULL;
+        return h ^ (h >> 29);
+    };
+    auto loadWord = [bytes](size_t w) {
+        uint64_t word;
+        std::memcpy(&word, bytes + w * sizeof(uint64_t), sizeof(uint64_t));
+        return word;
+    };
+    // 4개의 독립된 lane으로 곱셈 latency를 숨긴다.
+    uint64_t lanes[4] = {0xcbf29ce484222325ULL ^ nbBytes, 1, 2, 3};
+    size_t w = 0;
+    for (; w + 3 * step < numWords; w += 4 * step) {
+        for (int l = 0; l < 4; ++l) {
+            lanes[l] = mix(lanes[l], loadWord(w + l * step));
+        }
+    }
+    for (; w < numWords; w += step) {
+        lanes[0] = mix(lanes[0], loadWord(w));
+    }
+    for (size_t i = numWords * sizeof(uint64_t); i < nbBytes; ++i) {
+        lanes[0] = mix(lanes[0], bytes[i]);
+    }
+    return mix(mix(mix(lanes[0], lanes[1]), lanes[2]), lanes[3]);
+}
+
+inline uint64_t combineDigest(uint64_t seed, uint64_t digest) {
+    seed ^= digest + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    return seed;
+}
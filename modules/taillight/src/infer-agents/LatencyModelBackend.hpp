@@ -0,0 +1,93 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "InferBackend.hpp"
+#include "taillight/common.hpp"
+#include "trt_utils/common.h"
+
+/*
+ * GPU 없는 환경에서 engine의 시간을 흉내 낸다. output은 inner backend (cpu, replay)가 만들고,
+ * 호출마다 LatencyModel 만큼 지난 뒤에 반환한다.
+ *   setInput / getOutput : binding bytes / copyGBps
+ *   execute(realB)       : fixedMs + perItemMs * realB
+ * inner backend의 실행 시간도 지연에 포함된다. (호출 시간 = max(inner, model))
+ * pipelining, batching, scheduling 변경을 개발 PC에서 평가하기 위한 용도.
+ */
+class LatencyModelBackend : public IInferBackend {
+
+  public:
+    // spin: sleep 대신 busy-wait. (thread 깨우는 지연 없이 정확하지만 core 하나를 점유)
+    LatencyModelBackend(std::unique_ptr<IInferBackend> inner, const LatencyModel &model, bool spin)
+        : mInner(std::move(inner)), mModel(model), mSpin(spin) {}
+
+    const char *name() const override { return "latency"; }
+
+    int numBindings() const override { return mInner->numBindings(); }
+    std::string bindingName(int bindingIdx) const override {
+        return mInner->bindingName(bindingIdx);
+    }
+    int bindingIndex(const std::string &tensorName) const override {
+        return mInner->bindingIndex(tensorName);
+    }
+    nvinfer1::Dims bindingDims(int bindingIdx) const override {
+        return mInner->bindingDims(bindingIdx);
+    }
+    nvinfer1::DataType bindingType(int bindingIdx) const override {
+        return mInner->bindingType(bindingIdx);
+    }
+    bool bindingIsInput(int bindingIdx) const override {
+        return mInner->bindingIsInput(bindingIdx);
+    }
+
+    void setInput(const std::string &tensorName, const void *hostPtr) override {
+        const Clock::time_point begin = Clock::now();
+        mInner->setInput(tensorName, hostPtr);
+        waitUntil(begin, copyMs(tensorName));
+    }
+    void getOutput(const std::string &tensorName, void *hostPtr) override {
+        const Clock::time_point begin = Clock::now();
+        mInner->getOutput(tensorName, hostPtr);
+        waitUntil(begin, copyMs(tensorName));
+    }
+
+    void execute(int realB) override {
+        const Clock::time_point begin = Clock::now();
+        mInner->execute(realB);
+        waitUntil(begin, mModel.fixedMs + mModel.perItemMs * realB);
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    double copyMs(const std::string &tensorName) const {
+        if (mModel.copyGBps <= 0.0) {
+            return 0.0;
+        }
+        const int index = mInner->bindingIndex(tensorName);
+        if (index == -1) {
+            std::cout << "Wrong Tensor Name" << std::endl;
+            exit(1);
+        }
+        const double nbBytes = static_cast<double>(volume(mInner->bindingDims(index))) *
+                               getTypeSize(mInner->bindingType(index));
+        return nbBytes / (mModel.copyGBps * 1e6); // GB/s -> bytes/ms
+    }
+
+    void waitUntil(Clock::time_point begin, double durationMs) const {
+        const Clock::time_point end =
+            begin + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double, std::milli>(durationMs));
+        if (mSpin) {
+            while (Clock::now() < end) {
+            }
+        } else {
+            std::this_thread::sleep_until(end);
+        }
+    }
+
+    std::unique_ptr<IInferBackend> mInner;
+    const LatencyModel mModel;
+    const bool mSpin;
+};
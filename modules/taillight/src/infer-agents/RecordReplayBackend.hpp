@@ -0,0 +1,434 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+#include "InferBackend.hpp"
+#include "trt_utils/common.h"
+
+/*
+ * agent execute 호출의 기록 / 재생.
+ * RecordingBackend는 실제 backend (GPU run)를 감싸 execute마다 input digest와 output tensor를
+ * log에 추가한다. ReplayBackend는 log를 mmap 하여 engine 없이 기록된 output을 그대로 돌려주므로
+ * Regress -> UNet -> tracker -> CNN3D 흐름을 GPU 없이 bit 단위로 재현할 수 있다.
+ * 재생할 entry는 호출 순서 (sequence) 또는 input digest로 찾는다.
+ * input digest와 output 모두 유효한 앞쪽 realB개의 batch slot만 대상으로 한다. (tensor는 batch-major)
+ *
+ * log 형식 (little endian, agent (engine)마다 하나)
+ *   FileHeader, BindingHeader x numBindings,
+ *   { EntryHeader, output bytes (output binding 순서대로, binding마다 realB slot) } x 호출 수
+ * 기록 중 종료되어 잘린 마지막 entry는 재생 시 무시한다.
+ *
+ * entry 크기는 realB x (slot 당 output bytes) + 32 bytes.
+ * UNet은 slot 당 200 KB (64 x 28 x 28 float)이므로 track 8개면 호출마다 1.6 MB, 30 fps에서 약 48 MB/s.
+ * feature는 압축이 거의 되지 않아 별도 encoding 없이 그대로 쓴다. 긴 기록에는 충분한 disk를 확보한다.
+ */
+namespace InferLog {
+
+constexpr char kMagic[8] = {'T', 'L', 'I', 'N', 'F', 'L', 'O', 'G'};
+constexpr uint32_t kVersion = 2;
+constexpr int kMaxNameLen = 64;
+constexpr int kMaxDims = 8;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numBindings;
+};
+
+struct BindingHeader {
+    char name[kMaxNameLen];
+    int32_t nbDims;
+    int32_t d[kMaxDims];
+    int32_t type;
+    int32_t isInput;
+};
+
+struct EntryHeader {
+    uint64_t seq;
+    uint64_t inputDigest; // input binding 순서로 앞쪽 realB slot을 combineDigest 한 값
+    uint32_t realB;       // 기록된 batch slot 수
+    uint32_t reserved;
+    uint64_t nbBytes; // 이어지는 output bytes
+};
+
+inline size_t bindingBytes(const IInferBackend &backend, int bindingIdx) {
+    return static_cast<size_t>(volume(backend.bindingDims(bindingIdx))) *
+           getTypeSize(backend.bindingType(bindingIdx));
+}
+
+// batch slot 하나의 bytes. (첫 axis가 batch)
+inline size_t slotBytes(const IInferBackend &backend, int bindingIdx) {
+    const nvinfer1::Dims dims = backend.bindingDims(bindingIdx);
+    const size_t numBatches = dims.nbDims > 0 ? static_cast<size_t>(std::max(dims.d[0], 1)) : 1;
+    return bindingBytes(backend, bindingIdx) / numBatches;
+}
+
+// binding 순서로 input의 앞쪽 realB slot digest를 합친다.
+inline uint64_t inputDigest(
+    const IInferBackend &backend, const std::vector<const void *> &inputs, int realB) {
+    uint64_t digest = 0;
+    for (int i = 0; i < backend.numBindings(); ++i) {
+        if (backend.bindingIsInput(i)) {
+            const size_t nbBytes = inputs[i] ? realB * slotBytes(backend, i) : 0;
+            digest = combineDigest(digest, digestBytes(inputs[i], nbBytes));
+        }
+    }
+    return digest;
+}
+
+} // namespace InferLog
+
+// inner backend를 그대로 사용하면서 execute마다 log에 기록.
+class RecordingBackend : public IInferBackend {
+
+  public:
+    RecordingBackend(std::unique_ptr<IInferBackend> inner, const std::string &logPath)
+        : mInner(std::move(inner)), mLogFile(logPath, std::ios::binary | std::ios::trunc) {
+        if (mLogFile.fail()) {
+            std::cout << "Error opening inference log: " << logPath << std::endl;
+            exit(1);
+        }
+
+        InferLog::FileHeader fileHeader{};
+        std::memcpy(fileHeader.magic, InferLog::kMagic, sizeof(fileHeader.magic));
+        fileHeader.version = InferLog::kVersion;
+        fileHeader.numBindings = static_cast<uint32_t>(mInner->numBindings());
+        append(&fileHeader, sizeof(fileHeader));
+
+        mInputs.assign(mInner->numBindings(), nullptr);
+        mOutputs.resize(mInner->numBindings());
+        for (int i = 0; i < mInner->numBindings(); ++i) {
+            const std::string name = mInner->bindingName(i);
+            const nvinfer1::Dims dims = mInner->bindingDims(i);
+            if (static_cast<int>(name.size()) >= InferLog::kMaxNameLen ||
+                dims.nbDims > InferLog::kMaxDims) {
+                std::cout << "Inference log: unsupported binding " << name << std::endl;
+                exit(1);
+            }
+
+            InferLog::BindingHeader bindingHeader{};
+            std::memcpy(bindingHeader.name, name.c_str(), name.size());
+            bindingHeader.nbDims = dims.nbDims;
+            std::copy(dims.d, dims.d + dims.nbDims, bindingHeader.d);
+            bindingHeader.type = static_cast<int32_t>(mInner->bindingType(i));
+            bindingHeader.isInput = mInner->bindingIsInput(i);
+            append(&bindingHeader, sizeof(bindingHeader));
+
+            if (!mInner->bindingIsInput(i)) {
+                mOutputs[i].assign(InferLog::bindingBytes(*mInner, i), 0);
+            }
+        }
+    }
+
+    const char *name() const override { return "record"; }
+
+    int numBindings() const override { return mInner->numBindings(); }
+    std::string bindingName(int bindingIdx) const override {
+        return mInner->bindingName(bindingIdx);
+    }
+    int bindingIndex(const std::string &tensorName) const override {
+        return mInner->bindingIndex(tensorName);
+    }
+    nvinfer1::Dims bindingDims(int bindingIdx) const override {
+        return mInner->bindingDims(bindingIdx);
+    }
+    nvinfer1::DataType bindingType(int bindingIdx) const override {
+        return mInner->bindingType(bindingIdx);
+    }
+    bool bindingIsInput(int bindingIdx) const override {
+        return mInner->bindingIsInput(bindingIdx);
+    }
+
+    void setInput(const std::string &tensorName, const void *hostPtr) override {
+        mInputs[checkedIndex(tensorName)] = hostPtr; // execute 까지 유효 (digest는 execute에서)
+        mInner->setInput(tensorName, hostPtr);
+    }
+    // execute() 때 받아둔 output을 복사. (device에서 다시 읽지 않는다.)
+    void getOutput(const std::string &tensorName, void *hostPtr) override {
+        const std::vector<uint8_t> &output = mOutputs[checkedIndex(tensorName)];
+        std::memcpy(hostPtr, output.data(), output.size());
+    }
+
+    void execute(int realB) override {
+        mInner->execute(realB);
+
+        InferLog::EntryHeader entryHeader{};
+        entryHeader.seq = mSeq++;
+        entryHeader.inputDigest = InferLog::inputDigest(*mInner, mInputs, realB);
+        entryHeader.realB = static_cast<uint32_t>(realB);
+        for (int i = 0; i < mInner->numBindings(); ++i) {
+            if (!mInner->bindingIsInput(i)) {
+                mInner->getOutput(mInner->bindingName(i), mOutputs[i].data());
+                entryHeader.nbBytes += realB * InferLog::slotBytes(*mInner, i);
+            }
+        }
+
+        // realB 이후의 slot은 결과로 쓰이지 않으므로 기록하지 않는다.
+        append(&entryHeader, sizeof(entryHeader));
+        for (int i = 0; i < mInner->numBindings(); ++i) {
+            if (!mInner->bindingIsInput(i)) {
+                append(mOutputs[i].data(), realB * InferLog::slotBytes(*mInner, i));
+            }
+        }
+    }
+
+  private:
+    int checkedIndex(const std::string &tensorName) const {
+        const int index = mInner->bindingIndex(tensorName);
+        if (index == -1) {
+            std::cout << "Wrong Tensor Name" << std::endl;
+            exit(1);
+        }
+        return index;
+    }
+
+    void append(const void *data, size_t nbBytes) {
+        mLogFile.write(static_cast<const char *>(data), nbBytes);
+        if (mLogFile.fail()) {
+            std::cout << "Error writing inference log." << std::endl;
+            exit(1);
+        }
+    }
+
+    std::unique_ptr<IInferBackend> mInner;
+    std::ofstream mLogFile;
+    uint64_t mSeq{0};
+    std::vector<const void *> mInputs;          // binding별 마지막 setInput의 host pointer
+    std::vector<std::vector<uint8_t>> mOutputs; // binding별 마지막 output (input은 비어 있음)
+};
+
+// RecordingBackend의 log를 재생. binding 정보도 log에서 읽는다.
+class ReplayBackend : public IInferBackend {
+
+  public:
+    // matchByDigest: input digest가 같은 첫 entry를 재생. 아니면 호출 순서대로 재생하고
+    // input digest가 기록과 다르면 (입력이 달라진 경우) 알린다.
+    ReplayBackend(const std::string &logPath, bool matchByDigest)
+        : mLogPath(logPath), mMatchByDigest(matchByDigest) {
+        mapLog();
+        parseBindings();
+        indexEntries();
+        std::cout << "replay: " << mEntryOffsets.size() << " calls (" << mLogPath << ")"
+                  << std::endl;
+    }
+
+    ~ReplayBackend() override {
+        if (mNumMismatches > 0) {
+            std::cout << "replay: " << mNumMismatches << " / " << mNextSeq
+                      << " calls with different input (" << mLogPath << ")" << std::endl;
+        }
+        if (mData != nullptr) {
+            munmap(const_cast<uint8_t *>(mData), mSize);
+        }
+    }
+
+    ReplayBackend(const ReplayBackend &) = delete;
+    ReplayBackend &operator=(const ReplayBackend &) = delete;
+
+    const char *name() const override { return "replay"; }
+
+    int numBindings() const override { return static_cast<int>(mBindings.size()); }
+    std::string bindingName(int bindingIdx) const override {
+        return bindingAt(bindingIdx).name;
+    }
+    int bindingIndex(const std::string &tensorName) const override {
+        for (size_t i = 0; i < mBindings.size(); ++i) {
+            if (tensorName == mBindings[i].name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    nvinfer1::Dims bindingDims(int bindingIdx) const override {
+        const InferLog::BindingHeader &binding = bindingAt(bindingIdx);
+        return toDims(std::vector<int>(binding.d, binding.d + binding.nbDims));
+    }
+    nvinfer1::DataType bindingType(int bindingIdx) const override {
+        return static_cast<nvinfer1::DataType>(bindingAt(bindingIdx).type);
+    }
+    bool bindingIsInput(int bindingIdx) const override {
+        return bindingAt(bindingIdx).isInput != 0;
+    }
+
+    void setInput(const std::string &tensorName, const void *hostPtr) override {
+        mInputs[checkedIndex(tensorName, true)] = hostPtr;
+    }
+    // 기록된 realB slot을 복사하고 나머지 slot은 0으로 채운다.
+    void getOutput(const std::string &tensorName, void *hostPtr) override {
+        if (mCurrentEntry < 0) {
+            std::cout << "Replay: getOutput before execute" << std::endl;
+            exit(1);
+        }
+        const int index = checkedIndex(tensorName, false);
+        const size_t realB = entryAt(mCurrentEntry).realB;
+        const uint8_t *output = mData + mEntryOffsets[mCurrentEntry] +
+                                sizeof(InferLog::EntryHeader) + realB * mSlotOffsets[index];
+        const size_t nbBytes = realB * InferLog::slotBytes(*this, index);
+        std::memcpy(hostPtr, output, nbBytes);
+        std::memset(
+            static_cast<uint8_t *>(hostPtr) + nbBytes, 0,
+            InferLog::bindingBytes(*this, index) - nbBytes);
+    }
+
+    void execute(int realB) override {
+        const uint64_t inputDigest = InferLog::inputDigest(*this, mInputs, realB);
+
+        if (mMatchByDigest) {
+            auto it = mDigestIndex.find(inputDigest);
+            if (it == mDigestIndex.end()) {
+                std::cout << "Replay: no recorded call for this input (" << mLogPath << ")"
+                          << std::endl;
+                exit(1);
+            }
+            mCurrentEntry = it->second;
+            ++mNextSeq;
+            return;
+        }
+
+        if (mNextSeq >= mEntryOffsets.size()) {
+            std::cout << "Replay: log exhausted after " << mNextSeq << " calls (" << mLogPath
+                      << ")" << std::endl;
+            exit(1);
+        }
+        mCurrentEntry = static_cast<int64_t>(mNextSeq++);
+        if (entryAt(mCurrentEntry).inputDigest != inputDigest) {
+            if (mNumMismatches == 0) {
+                std::cout << "replay: input differs from record at call " << mCurrentEntry
+                          << " (" << mLogPath << ")" << std::endl;
+            }
+            ++mNumMismatches;
+        }
+    }
+
+  private:
+    void mapLog() {
+        const int fd = open(mLogPath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cout << "Error opening inference log: " << mLogPath << std::endl;
+            exit(1);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(InferLog::FileHeader))) {
+            std::cout << "Invalid inference log: " << mLogPath << std::endl;
+            exit(1);
+        }
+        mSize = static_cast<size_t>(st.st_size);
+        void *data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // mapping은 fd를 닫아도 유지된다.
+        if (data == MAP_FAILED) {
+            std::cout << "Error mapping inference log: " << mLogPath << std::endl;
+            exit(1);
+        }
+        mData = static_cast<const uint8_t *>(data);
+    }
+
+    void parseBindings() {
+        InferLog::FileHeader fileHeader;
+        std::memcpy(&fileHeader, mData, sizeof(fileHeader));
+        if (std::memcmp(fileHeader.magic, InferLog::kMagic, sizeof(fileHeader.magic)) != 0 ||
+            fileHeader.version != InferLog::kVersion) {
+            std::cout << "Invalid inference log: " << mLogPath << std::endl;
+            exit(1);
+        }
+
+        size_t offset = sizeof(fileHeader);
+        if (offset + fileHeader.numBindings * sizeof(InferLog::BindingHeader) > mSize) {
+            std::cout << "Invalid inference log: " << mLogPath << std::endl;
+            exit(1);
+        }
+        mBindings.resize(fileHeader.numBindings);
+        for (InferLog::BindingHeader &binding : mBindings) {
+            std::memcpy(&binding, mData + offset, sizeof(binding));
+            binding.name[InferLog::kMaxNameLen - 1] = '\0';
+            if (binding.nbDims < 0 || binding.nbDims > InferLog::kMaxDims) {
+                std::cout << "Invalid inference log: " << mLogPath << std::endl;
+                exit(1);
+            }
+            offset += sizeof(binding);
+        }
+        mEntriesBegin = offset;
+
+        mInputs.assign(mBindings.size(), nullptr);
+        mSlotOffsets.assign(mBindings.size(), 0);
+        for (size_t i = 0; i < mBindings.size(); ++i) {
+            if (!mBindings[i].isInput) {
+                mSlotOffsets[i] = mSlotBytes;
+                mSlotBytes += InferLog::slotBytes(*this, static_cast<int>(i));
+                const int numBatches = mBindings[i].nbDims > 0 ? mBindings[i].d[0] : 1;
+                mMaxBatch = std::min(mMaxBatch, static_cast<uint32_t>(std::max(numBatches, 1)));
+            }
+        }
+    }
+
+    void indexEntries() {
+        size_t offset = mEntriesBegin;
+        while (offset + sizeof(InferLog::EntryHeader) <= mSize) {
+            InferLog::EntryHeader entryHeader;
+            std::memcpy(&entryHeader, mData + offset, sizeof(entryHeader));
+            if (entryHeader.nbBytes != entryHeader.realB * mSlotBytes ||
+                entryHeader.realB > mMaxBatch) {
+                std::cout << "Invalid inference log entry: " << mLogPath << std::endl;
+                exit(1);
+            }
+            if (offset + sizeof(entryHeader) + entryHeader.nbBytes > mSize) {
+                break;
+            }
+            if (mMatchByDigest) {
+                mDigestIndex.emplace(entryHeader.inputDigest, mEntryOffsets.size());
+            }
+            mEntryOffsets.push_back(offset);
+            offset += sizeof(entryHeader) + entryHeader.nbBytes;
+        }
+    }
+
+    const InferLog::BindingHeader &bindingAt(int bindingIdx) const {
+        if (bindingIdx < 0 || bindingIdx >= static_cast<int>(mBindings.size())) {
+            std::cout << "Wrong Tensor Index" << std::endl;
+            exit(1);
+        }
+        return mBindings[bindingIdx];
+    }
+
+    InferLog::EntryHeader entryAt(int64_t entryIdx) const {
+        InferLog::EntryHeader entryHeader;
+        std::memcpy(&entryHeader, mData + mEntryOffsets[entryIdx], sizeof(entryHeader));
+        return entryHeader;
+    }
+
+    int checkedIndex(const std::string &tensorName, bool isInput) const {
+        const int index = bindingIndex(tensorName);
+        if (index == -1) {
+            std::cout << "Wrong Tensor Name" << std::endl;
+            exit(1);
+        }
+        if (bindingIsInput(index) != isInput) {
+            std::cout << "Memcpy: Wrong Direction." << std::endl;
+            exit(1);
+        }
+        return index;
+    }
+
+    const std::string mLogPath;
+    const bool mMatchByDigest;
+    const uint8_t *mData{nullptr}; // mmap 된 log 전체
+    size_t mSize{0};
+
+    std::vector<InferLog::BindingHeader> mBindings;
+    std::vector<size_t> mSlotOffsets; // binding 앞의 output slot bytes 합. entry 안에서는 x realB
+    size_t mSlotBytes{0};             // batch slot 하나의 output bytes (모든 output binding)
+    uint32_t mMaxBatch{UINT32_MAX};   // output binding의 batch 크기
+    size_t mEntriesBegin{0};
+    std::vector<size_t> mEntryOffsets;
+    std::unordered_map<uint64_t, size_t> mDigestIndex; // input digest -> 첫 entry
+
+    std::vector<const void *> mInputs; // binding별 마지막 setInput의 host pointer
+    int64_t mCurrentEntry{-1};
+    uint64_t mNextSeq{0};
+    uint64_t mNumMismatches{0};
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <fstream>
+
+#include <NvInfer.h>
+#include <cuda_runtime_api.h>
+
+#include "InferBackend.hpp"
+#include "trt_utils/bufferManager.h"
+
+// serialize 된 TensorRT engine (.trt) 실행.
+class TrtBackend : public IInferBackend {
+
+  public:
+    TrtBackend(const std::string &trtFilePath) { loadEngine(trtFilePath); }
+
+    const char *name() const override { return "tensorrt"; }
+
+    int numBindings() const override { return mEngine->getNbBindings(); }
+    std::string bindingName(int bindingIdx) const override {
+        return mEngine->getBindingName(bindingIdx);
+    }
+    int bindingIndex(const std::string &tensorName) const override {
+        return mEngine->getBindingIndex(tensorName.c_str());
+    }
+    nvinfer1::Dims bindingDims(int bindingIdx) const override {
+        return mEngine->getBindingDimensions(bindingIdx);
+    }
+    nvinfer1::DataType bindingType(int bindingIdx) const override {
+        return mEngine->getBindingDataType(bindingIdx);
+    }
+    bool bindingIsInput(int bindingIdx) const override {
+        return mEngine->bindingIsInput(bindingIdx);
+    }
+
+    void setInput(const std::string &tensorName, const void *hostPtr) override {
+        // host -> device 방향이면 hostPtr은 읽기만 한다.
+        mBufManager->memcpy(true, tensorName, const_cast<void *>(hostPtr));
+    }
+    void getOutput(const std::string &tensorName, void *hostPtr) override {
+        mBufManager->memcpy(false, tensorName, hostPtr);
+    }
+
+    void execute(int /*realB*/) override {
+        std::vector<void *> buffers = mBufManager->getDeviceBindings();
+        if (!mContext->executeV2(buffers.data())) {
+            std::cout << "TRT execution failed" << std::endl;
+            exit(1);
+        }
+    }
+
+  private:
+    void loadEngine(const std::string &trtFilePath) {
+        std::ifstream engineFile(trtFilePath, std::ios::binary);
+        if (engineFile.fail()) {
+            std::cout << "Error opening TRT file." << std::endl;
+            exit(1);
+        }
+
+        engineFile.seekg(0, engineFile.end);
+        long int fsize = engineFile.tellg();
+        engineFile.seekg(0, engineFile.beg);
+
+        std::vector<char> engineData(fsize);
+        engineFile.read(engineData.data(), fsize);
+        if (engineFile.fail()) {
+            std::cout << "Error reading TRT file." << std::endl;
+            exit(1);
+        }
+
+        UniquePtrTRT<nvinfer1::IRuntime> runtime{nvinfer1::createInferRuntime(gLogger)};
+        // if (DLACore != -1) { runtime->setDLACore(DLACore); }
+        mEngine = std::shared_ptr<nvinfer1::ICudaEngine>(
+            runtime->deserializeCudaEngine(engineData.data(), fsize, nullptr),
+            InferDeleter());
+        if (!mEngine) {
+            std::cout << "Error deserializing TRT engine." << std::endl;
+            exit(1);
+        }
+
+        // -----------------------
+        // Create buffer manager
+        // -----------------------
+        mBufManager = std::make_unique<BufferManager>(mEngine);
+
+        // ---------------
+        // Create context
+        // ---------------
+        mContext = UniquePtrTRT<nvinfer1::IExecutionContext>(mEngine->createExecutionContext());
+    }
+
+    std::unique_ptr<BufferManager> mBufManager{nullptr};
+    std::shared_ptr<nvinfer1::ICudaEngine> mEngine{nullptr};
+    UniquePtrTRT<nvinfer1::IExecutionContext> mContext{nullptr};
+};
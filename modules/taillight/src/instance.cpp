@@ -1,64 +1,14 @@
 #include "taillight/instance.hpp"
+#include "taillight/HullRaster.hpp"
+#include "taillight/InstanceBatch.hpp"
 #include <algorithm>
-#include <opencv2/core/eigen.hpp>
-
-Instance::Instance(
-    int classId,
-    int trackId,
-    std::array<float, 3> xyz,
-    std::array<float, 3> lwh,
-    float yaw,
-    const CalibParams &calib_params) {
-
-    /* ---------------------*
-     * Set by input
-     * ---------------------*/
-    mClassId = classId;
-    mTrackId = trackId;
-    mXyzCenter << xyz[0], xyz[1], xyz[2];
-    mLwh << lwh[0], lwh[1], lwh[2];
-    mYaw = yaw;
-
-    /* ---------------------*
-     * Set corners (3D, 2D)
-     * ---------------------*/
-    // clang-format off
-    mCorners3D << -1, -1, -1, -1, 1, 1, 1, 1, 
-                  -1, -1, 1, 1, -1, -1, 1, 1,
-                  -1, 1, -1, 1, -1, 1, -1, 1;
-    // clang-format on
-    mCorners3D.array().colwise() *= (0.5 * mLwh.array());
-
-    // Rotate and Translate
-    const Eigen::Affine3f transform =
-        Eigen::Translation3f(mXyzCenter) * Eigen::AngleAxisf(mYaw, Eigen::Vector3f(0, 0, 1));
-    mCorners3D = transform * mCorners3D;
-
-    // camera coordinates
-    mCornersCam3D =
-        (calib_params.T_veh2cam * mCorners3D.colwise().homogeneous()).colwise().hnormalized();
-
-    // Project Corners to image
-    mCorners2D = (calib_params.K * mCornersCam3D).colwise().hnormalized();
-
-    /* ----------------------------------*
-     * Minimun distance to box (roughly)
-     * ----------------------------------*/
-    mDist = mCorners3D.topRows(2).colwise().norm().minCoeff();
-
-    /* ----*
-     * ETC
-     * ----*/
-    mDisplayStr += std::to_string(mClassId) + "(" + std::to_string(mTrackId) + ") ";
-}
-
-bool Instance::isAnyCornersInImage(int imgH, int imgW) const {
 
-    const Eigen::Matrix<float, 1, 8> cornersU = mCorners2D.row(0);
-    const Eigen::Matrix<float, 1, 8> cornersV = mCorners2D.row(1);
+bool Instance::isAnyCornersInImage() const {
+    const auto cornersU = mBatch->cornersU(mIdx);
+    const auto cornersV = mBatch->cornersV(mIdx);
 
-    const Eigen::Matrix<bool, 1, 8> valid = cornersU.array() > 0 && cornersU.array() < imgW &&
-                                            cornersV.array() > 0 && cornersV.array() < imgH;
+    const Eigen::Array<bool, 8, 1> valid = cornersU > 0 && cornersU < mBatch->imgW() &&
+                                           cornersV > 0 && cornersV < mBatch->imgH();
 
     return valid.any();
 }
@@ -69,19 +19,18 @@ bool Instance::isAnyCornersInImage(int imgH, int imgW) const {
  * 다른 corner는 camera에 잡힐 수 있다.
  * 추후 해결 필요.
  */
-bool Instance::isAllCornersFrontOfCam() const {
-    const Eigen::Matrix<float, 1, 8> cornersCamZ = mCornersCam3D.row(2);
-    const Eigen::Matrix<bool, 1, 8> valid = cornersCamZ.array() > 0;
+bool Instance::isAllCornersFrontOfCam() const { return (mBatch->cornersCamZ(mIdx) > 0).all(); }
 
-    return valid.all();
-}
+// InstanceBatch::project()에서 두 조건을 전체 object에 대해 미리 계산해둔다.
+bool Instance::isValidProjection() const { return mBatch->isValidProjection(mIdx); }
 
-bool Instance::isValidProjection(int imgH, int imgW) const {
-    return isAnyCornersInImage(imgH, imgW) && isAllCornersFrontOfCam();
-}
+float Instance::dist() const { return mBatch->dist(mIdx); }
+
+int Instance::trackId() const { return mBatch->trackId(mIdx); }
 
 bool Instance::isCar() const {
-    if (mClassId == 0 || mClassId == 1) {
+    const int classId = mBatch->classId(mIdx);
+    if (classId == 0 || classId == 1) {
         return true;
     } else {
         return false;
@@ -89,17 +38,19 @@ bool Instance::isCar() const {
 }
 
 void Instance::renderToImg(cv::Mat &img) const {
+    const auto cornersU = mBatch->cornersU(mIdx);
+    const auto cornersV = mBatch->cornersV(mIdx);
 
-    auto renderPairs = [&img,
-                        this](const std::vector<std::pair<int, int>> &pairs, cv::Scalar color) {
+    auto renderPairs = [&img, &cornersU, &cornersV](
+                           const std::vector<std::pair<int, int>> &pairs, cv::Scalar color) {
         for (const auto &p : pairs) {
             cv::Point point1{
-                static_cast<int>(this->mCorners2D(0, p.first) + 0.5),
-                static_cast<int>(this->mCorners2D(1, p.first) + 0.5),
+                static_cast<int>(cornersU(p.first) + 0.5),
+                static_cast<int>(cornersV(p.first) + 0.5),
             };
             cv::Point point2{
-                static_cast<int>(this->mCorners2D(0, p.second) + 0.5),
-                static_cast<int>(this->mCorners2D(1, p.second) + 0.5),
+                static_cast<int>(cornersU(p.second) + 0.5),
+                static_cast<int>(cornersV(p.second) + 0.5),
             };
             cv::line(img, point1, point2, color);
         }
@@ -135,67 +86,94 @@ void Instance::renderToImg(cv::Mat &img) const {
 
     // Render display string
     const cv::Point strPos{
-        static_cast<int>(mCorners2D(0, 0) + 0.5),
-        static_cast<int>(mCorners2D(1, 0) + 0.5),
+        static_cast<int>(cornersU(0) + 0.5),
+        static_cast<int>(cornersV(0) + 0.5),
     };
 
-    cv::putText(img, mDisplayStr, strPos, cv::FONT_HERSHEY_PLAIN, 1, cv::Scalar(0, 0, 255), 2);
+    // 표시할 문자열은 render 할 때만 만든다.
+    std::string displayStr =
+        std::to_string(mBatch->classId(mIdx)) + "(" + std::to_string(trackId()) + ") ";
+    const InstanceAnnotation &note = mBatch->annotationAt(mIdx);
+    if (!std::isnan(note.yawByViewDeg)) {
+        displayStr += std::to_string(static_cast<int>(note.yawByViewDeg)) + " ";
+    }
+    if (note.tailSize >= 0) {
+        displayStr += std::to_string(note.tailSize) + " ";
+    }
+    if (note.occluded >= 0) {
+        displayStr += std::to_string(note.occluded) + " ";
+    }
+    if (note.reason != RejectReason::kNone && note.reason != RejectReason::kNotEvaluated) {
+        displayStr += rejectReasonName(note.reason);
+    }
+
+    cv::putText(
+        img,
+        displayStr,
+        strPos,
+        cv::FONT_HERSHEY_PLAIN,
+        1,
+        cv::Scalar(0, 0, 255),
+        2);
 }
 
-bool Instance::isTailInSight(int imgH, int imgW, const ArrayXXb &occMask) const {
+bool Instance::isTailInSight(const OcclusionMap &occMask, bool silhouette) const {
+    // annotation이 꺼져 있으면 nullptr
+    InstanceAnnotation *note = mBatch->annotation(mIdx);
+
     // 1. 자동차 맞는지
     if (!isCar())
-        return false;
+        return mBatch->record(mIdx, RejectReason::kNotCar);
 
     // 2. tail과 view의 각도
-    // yawByView : 차량 뒷면을 바라보는 angle과 차량 yaw angle 간의 차이
-    const Eigen::Vector3f tailCenter = mCornersCam3D.leftCols(4).rowwise().mean();
-    const float viewAngleToTail = atan2(-tailCenter(0), tailCenter(2));
-    const float yawByView = abs(angleDiff(viewAngleToTail, mYaw));
-    mDisplayStr += std::to_string(static_cast<int>(yawByView * 180 / M_PI)) + " ";
+    // yawByView : 차량 뒷면을 바라보는 angle과 차량 yaw angle 간의 차이 (project()에서 계산)
+    const float yawByView = mBatch->yawByView(mIdx);
+    if (note)
+        note->yawByViewDeg = yawByView * 180 / M_PI;
     if (yawByView > 0.25 * M_PI)
-        return false;
+        return mBatch->record(mIdx, RejectReason::kTailAngle);
 
     // 3. tail corner가 모두 이미지 안에 있는지...
-    const Eigen::Matrix<float, 2, 4> tailCorners2D = mCorners2D.leftCols(4);
-    const Eigen::Matrix<float, 1, 4> tailCornersU = tailCorners2D.row(0);
-    const Eigen::Matrix<float, 1, 4> tailCornersV = tailCorners2D.row(1);
-
-    const Eigen::Matrix<bool, 1, 4> valid =
-        tailCornersU.array() > 0 && tailCornersU.array() < imgW && tailCornersV.array() > 0 &&
-        tailCornersV.array() < imgH;
-
-    if (!valid.all())
-        return false;
+    if (!mBatch->isTailInImage(mIdx))
+        return mBatch->record(mIdx, RejectReason::kTailOutOfImage);
 
     // 4. tail projection의 size가 충분히 큰지.
-    auto [tailU, tailV, tailW, tailH] = getTailRect(imgH, imgW, 0.0);
-    const int tailMaskSize = tailW * tailH;
-    mDisplayStr += std::to_string(tailMaskSize) + " ";
+    int tailMaskSize = 0;
+    int intersection = 0;
+    if (silhouette) {
+        std::tie(intersection, tailMaskSize) = silhouetteCoverage(occMask, true);
+    } else {
+        auto [tailU, tailV, tailW, tailH] = getTailRect(0.0);
+        tailMaskSize = tailW * tailH;
+        if (tailMaskSize >= 50 * 50) {
+            intersection = occMask.count(tailV, tailU, tailH, tailW);
+        }
+    }
+    if (note)
+        note->tailSize = tailMaskSize;
     if (tailMaskSize < 50 * 50)
-        return false;
+        return mBatch->record(mIdx, RejectReason::kTailTooSmall);
 
     // 5. 전방의 물체에 가리진 않는지.
-    const int intersection = occMask.block(tailV, tailU, tailH, tailW).count();
-    mDisplayStr += std::to_string(intersection) + " ";
+    if (note)
+        note->occluded = intersection;
     if (static_cast<float>(intersection) / static_cast<float>(tailMaskSize) > 0.1)
-        return false;
+        return mBatch->record(mIdx, RejectReason::kOccluded);
 
+    mBatch->record(mIdx, RejectReason::kNone);
     return true;
 };
 
-std::tuple<int, int, int, int> Instance::getTailRect(int imgH, int imgW, float padRatio) const {
-    const Eigen::Matrix<float, 2, 4> tailCorners2D = mCorners2D.leftCols(4);
-    const Eigen::Matrix<float, 1, 4> tailCornersU = tailCorners2D.row(0);
-    const Eigen::Matrix<float, 1, 4> tailCornersV = tailCorners2D.row(1);
-
-    const float minU = tailCornersU.minCoeff();
-    const float maxU = tailCornersU.maxCoeff();
-    const float minV = tailCornersV.minCoeff();
-    const float maxV = tailCornersV.maxCoeff();
+std::tuple<int, int, int, int> Instance::getTailRect(float padRatio) const {
+    const float minU = mBatch->tailMinU(mIdx);
+    const float maxU = mBatch->tailMaxU(mIdx);
+    const float minV = mBatch->tailMinV(mIdx);
+    const float maxV = mBatch->tailMaxV(mIdx);
     const float padW = (maxU - minU) * padRatio;
     const float padH = (maxV - minV) * padRatio;
 
+    const int imgH = mBatch->imgH();
+    const int imgW = mBatch->imgW();
     const int minU_int = std::max(static_cast<int>(minU - padW + 0.5), 0);
     const int maxU_int = std::min(static_cast<int>(maxU + padW + 0.5), imgW - 1);
     const int minV_int = std::max(static_cast<int>(minV - padH + 0.5), 0);
@@ -205,15 +183,14 @@ std::tuple<int, int, int, int> Instance::getTailRect(int imgH, int imgW, float p
     return {minU_int, minV_int, maxU_int - minU_int, maxV_int - minV_int};
 }
 
-std::tuple<int, int, int, int> Instance::getBoundingRect(int imgH, int imgW) const {
-    const Eigen::Matrix<float, 1, 8> cornersU = mCorners2D.row(0);
-    const Eigen::Matrix<float, 1, 8> cornersV = mCorners2D.row(1);
-
-    const float minU = cornersU.minCoeff();
-    const float maxU = cornersU.maxCoeff();
-    const float minV = cornersV.minCoeff();
-    const float maxV = cornersV.maxCoeff();
+std::tuple<int, int, int, int> Instance::getBoundingRect() const {
+    const float minU = mBatch->boxMinU(mIdx);
+    const float maxU = mBatch->boxMaxU(mIdx);
+    const float minV = mBatch->boxMinV(mIdx);
+    const float maxV = mBatch->boxMaxV(mIdx);
 
+    const int imgH = mBatch->imgH();
+    const int imgW = mBatch->imgW();
     const int minU_int = std::max(static_cast<int>(minU + 0.5), 0);
     const int maxU_int = std::min(static_cast<int>(maxU + 0.5), imgW - 1);
     const int minV_int = std::max(static_cast<int>(minV + 0.5), 0);
@@ -223,26 +200,52 @@ std::tuple<int, int, int, int> Instance::getBoundingRect(int imgH, int imgW) con
     return {minU_int, minV_int, maxU_int - minU_int, maxV_int - minV_int};
 }
 
-// ----------------
-// Deprecated
-// ----------------
-MatrixXXb Instance::getMask(int imgH, int imgW, bool tailOnly) const {
+void Instance::fillSilhouette(OcclusionMap &occMask, bool tailOnly) const {
+    const Eigen::Array<float, 8, 1> cornersU = mBatch->cornersU(mIdx);
+    const Eigen::Array<float, 8, 1> cornersV = mBatch->cornersV(mIdx);
+    HullRaster::forEachSpan(
+        cornersU.data(),
+        cornersV.data(),
+        tailOnly ? 4 : 8,
+        mBatch->imgH(),
+        mBatch->imgW(),
+        [&occMask](int row, int colBegin, int colEnd) {
+            occMask.fillSpan(row, colBegin, colEnd);
+        });
+}
 
-    cv::Mat mask{imgH, imgW, CV_8UC1, cv::Scalar(0)};
+std::pair<int, int> Instance::silhouetteCoverage(const OcclusionMap &occMask, bool tailOnly) const {
+    const Eigen::Array<float, 8, 1> cornersU = mBatch->cornersU(mIdx);
+    const Eigen::Array<float, 8, 1> cornersV = mBatch->cornersV(mIdx);
+    int covered = 0;
+    int area = 0;
+    HullRaster::forEachSpan(
+        cornersU.data(),
+        cornersV.data(),
+        tailOnly ? 4 : 8,
+        mBatch->imgH(),
+        mBatch->imgW(),
+        [&occMask, &covered, &area](int row, int colBegin, int colEnd) {
+            covered += occMask.countSpan(row, colBegin, colEnd);
+            area += colEnd - colBegin;
+        });
+    return {covered, area};
+}
 
-    std::vector<cv::Point> points;
-    const int numCols = tailOnly ? 4 : mCorners2D.cols();
-    for (int c = 0; c < numCols; ++c) {
-        points.emplace_back(
-            static_cast<int>(mCorners2D(0, c) + 0.5),
-            static_cast<int>(mCorners2D(1, c) + 0.5));
-    }
-    std::vector<cv::Point> hull;
-    cv::convexHull(points, hull);
-    cv::fillConvexPoly(mask, hull, cv::Scalar{1});
-
-    // cv -> eigen
-    MatrixXXb maskEigen;
-    cv::cv2eigen(mask, maskEigen);
-    return maskEigen;
+// debugging 용. 이미지 크기의 mask로 convex hull을 rasterize.
+MatrixXXb Instance::getMask(bool tailOnly) const {
+    MatrixXXb mask = MatrixXXb::Zero(mBatch->imgH(), mBatch->imgW());
+
+    const Eigen::Array<float, 8, 1> cornersU = mBatch->cornersU(mIdx);
+    const Eigen::Array<float, 8, 1> cornersV = mBatch->cornersV(mIdx);
+    HullRaster::forEachSpan(
+        cornersU.data(),
+        cornersV.data(),
+        tailOnly ? 4 : 8,
+        mBatch->imgH(),
+        mBatch->imgW(),
+        [&mask](int row, int colBegin, int colEnd) {
+            mask.row(row).segment(colBegin, colEnd - colBegin).setConstant(true);
+        });
+    return mask;
 }
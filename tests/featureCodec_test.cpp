@@ -0,0 +1,138 @@
+/*
+ * feature storage (fp16, int8)의 encode / decode 오차 검증.
+ * 1. frame 단위 왕복 오차가 storage 별 한계 이내인지
+ * 2. 같은 detection 순서를 FP32 / compact pool의 track에 넣고 만든 CNN3D window를
+ *    CPU backend로 실행했을 때 output 차이가 input 오차로부터 정해지는 한계 이내인지
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "infer-agents/CpuBackend.hpp"
+#include "taillight/TrackedInst.hpp"
+
+namespace {
+
+constexpr int kNumFrames = 24;
+
+// 고정된 seed의 feature. 마지막 frame은 큰 outlier를 가진다. (INT8 scale 검증)
+std::vector<std::vector<float>> makeFrames() {
+    std::mt19937 rng(20210611);
+    std::normal_distribution<float> dist(0.0f, 1.5f);
+    std::vector<std::vector<float>> frames(kNumFrames, std::vector<float>(ENCODED_TAIL_SIZE));
+    for (auto &frame : frames) {
+        for (float &value : frame) {
+            value = dist(rng);
+        }
+    }
+    frames.back()[ENCODED_TAIL_SIZE / 2] = 64.0f;
+    return frames;
+}
+
+// storage 별 frame 왕복 오차 한계
+float codecBound(FeatStorage storage, float maxAbsRef) {
+    switch (storage) {
+    case FeatStorage::kFP32:
+        return 0.0f;
+    case FeatStorage::kFP16:
+        return maxAbsRef * std::ldexp(1.0f, -11) + std::ldexp(1.0f, -24);
+    case FeatStorage::kINT8:
+        return maxAbsRef / 254.0f * (1.0f + 1e-5f);
+    }
+    return 0.0f;
+}
+
+bool checkCodec(FeatStorage storage, const std::vector<std::vector<float>> &frames) {
+    for (size_t f = 0; f < frames.size(); ++f) {
+        const FeatCodec::CodecError err =
+            FeatCodec::measureError(storage, frames[f].data(), frames[f].size());
+        if (err.maxAbsErr > codecBound(storage, err.maxAbsRef)) {
+            std::cout << "FAIL codec(" << featStorageName(storage) << ") frame " << f
+                      << " maxAbsErr " << err.maxAbsErr << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// frames를 순서대로 track에 detection으로 넣는다. (3의 배수 frame은 miss)
+// 마지막 CNN3DCfg::inB 개 frame 직후의 window를 batch slot에 쓴다.
+std::vector<float> makeWindows(FeatStorage storage, const std::vector<std::vector<float>> &frames) {
+    EmbeddingPool pool(ENCODED_TAIL_SIZE, storage, CNN3DCfg::inSeqLen);
+    std::vector<float> windows(CNN3DCfg::inNumEl);
+    const size_t eachNumEl = CNN3DCfg::inNumEl / CNN3DCfg::inB;
+
+    int slot = pool.store(frames[0].data());
+    TrackedInst track(0, slot, 10.0f, 0, pool);
+    pool.release(slot);
+    for (int f = 1; f < kNumFrames; ++f) {
+        if (f % 3 == 0) {
+            track.updateMissed();
+        } else {
+            slot = pool.store(frames[f].data());
+            track.update(slot, 10.0f);
+            pool.release(slot);
+        }
+
+        const int batchIdx = f - (kNumFrames - CNN3DCfg::inB);
+        if (batchIdx >= 0) {
+            track.writeConcatedFeats(windows.data() + batchIdx * eachNumEl);
+        }
+    }
+    return windows;
+}
+
+std::vector<float> runCpuBackend(const std::vector<float> &windows) {
+    CpuBackend backend(
+        {{"Input",
+          std::vector<int>(CNN3DCfg::inDims.begin(), CNN3DCfg::inDims.end()),
+          nvinfer1::DataType::kFLOAT,
+          true},
+         {"Output",
+          {CNN3DCfg::outB, static_cast<int>(STATES.size())},
+          nvinfer1::DataType::kFLOAT,
+          false}});
+    std::vector<float> output(CNN3DCfg::outB * STATES.size());
+    backend.setInput("Input", windows.data());
+    backend.execute(CNN3DCfg::inB);
+    backend.getOutput("Output", output.data());
+    return output;
+}
+
+float maxAbsDiff(const std::vector<float> &lhs, const std::vector<float> &rhs) {
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        maxDiff = std::max(maxDiff, std::abs(lhs[i] - rhs[i]));
+    }
+    return maxDiff;
+}
+
+} // namespace
+
+int main() {
+    const std::vector<std::vector<float>> frames = makeFrames();
+    const std::vector<float> refWindows = makeWindows(FeatStorage::kFP32, frames);
+    const std::vector<float> refOutput = runCpuBackend(refWindows);
+
+    bool ok = true;
+    for (FeatStorage storage : {FeatStorage::kFP32, FeatStorage::kFP16, FeatStorage::kINT8}) {
+        ok = checkCodec(storage, frames) && ok;
+
+        // CPU backend의 output 오차는 input element 오차의 0.5배 이하이다. (CpuBackend.hpp)
+        const std::vector<float> windows = makeWindows(storage, frames);
+        const float inputErr = maxAbsDiff(refWindows, windows);
+        const float outputErr = maxAbsDiff(refOutput, runCpuBackend(windows));
+        std::cout << featStorageName(storage) << ": input maxAbsErr " << inputErr
+                  << ", output maxAbsErr " << outputErr << std::endl;
+        if (outputErr > 0.5f * inputErr + 1e-6f) {
+            std::cout << "FAIL output(" << featStorageName(storage) << ")" << std::endl;
+            ok = false;
+        }
+        if (storage == FeatStorage::kFP32 && (inputErr != 0.0f || outputErr != 0.0f)) {
+            std::cout << "FAIL fp32 storage is not lossless" << std::endl;
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+/*
+ * InputAdapter::prepend()가 만든 network를 TensorRT로 build / 실행하여
+ * CPU stand-in (InputAdapter::emulate())과 같은 결과인지 확인한다. GPU가 필요하다.
+ * network는 float NHWC input을 그대로 내보내는 identity 하나이므로 output은 변환 결과 자체이다.
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "trt_utils/bufferManager.h"
+#include "trt_utils/common.h"
+#include "trt_utils/inputAdapter.h"
+
+namespace {
+
+constexpr int kH = 5;
+constexpr int kW = 7; // pixel 수가 vector 폭의 배수가 아니도록
+constexpr int kNumEl = kH * kW * 3;
+
+bool checkSpec(const InputAdapter::Spec &spec) {
+    auto builder = UniquePtrTRT<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(gLogger));
+    const auto explicitBatch =
+        1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kEXPLICIT_BATCH);
+    auto network =
+        UniquePtrTRT<nvinfer1::INetworkDefinition>(builder->createNetworkV2(explicitBatch));
+
+    nvinfer1::ITensor *input =
+        network->addInput("Input", nvinfer1::DataType::kFLOAT, nvinfer1::Dims4{1, kH, kW, 3});
+    nvinfer1::ITensor *output = network->addIdentity(*input)->getOutput(0);
+    output->setName("Output");
+    network->markOutput(*output);
+
+    InputAdapter::PrefixWeights adapterWeights;
+    InputAdapter::prepend(*network, spec, adapterWeights);
+
+    auto config = UniquePtrTRT<nvinfer1::IBuilderConfig>(builder->createBuilderConfig());
+    config->setMaxWorkspaceSize(1 << 24);
+    InputAdapter::setBuilderFlags(*config);
+    std::shared_ptr<nvinfer1::ICudaEngine> engine(
+        builder->buildEngineWithConfig(*network, *config), InferDeleter());
+    if (!engine) {
+        std::cout << "FAIL engine build" << std::endl;
+        return false;
+    }
+    auto context = UniquePtrTRT<nvinfer1::IExecutionContext>(engine->createExecutionContext());
+    BufferManager buffers(engine);
+
+    // host가 기록하는 byte 값 그대로 (kINT8이면 pixel - 128)
+    std::mt19937 rng(3);
+    std::vector<uint8_t> bytes(kNumEl);
+    for (uint8_t &byte : bytes) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    std::vector<float> actual(kNumEl);
+    buffers.memcpy(true, "Input", bytes.data());
+    std::vector<void *> bindings = buffers.getDeviceBindings();
+    if (!context->executeV2(bindings.data())) {
+        std::cout << "FAIL execute" << std::endl;
+        return false;
+    }
+    buffers.memcpy(false, "Output", actual.data());
+
+    std::vector<float> expected(kNumEl);
+    InputAdapter::emulate(
+        spec, InputAdapter::byteInputType(), bytes.data(), expected.data(), kH * kW);
+
+    float maxErr = 0.0f;
+    for (int i = 0; i < kNumEl; ++i) {
+        const float err = std::abs(expected[i] - actual[i]) / (1.0f + std::abs(expected[i]));
+        maxErr = std::max(maxErr, err);
+    }
+    std::cout << "swapRB " << spec.swapRB << ": max relative error " << maxErr << std::endl;
+    return maxErr <= 1e-5f;
+}
+
+} // namespace
+
+int main() {
+    InputAdapter::Spec normalizeSpec;
+    normalizeSpec.swapRB = false;
+    normalizeSpec.mean = {123.7f, 116.3f, 103.5f};
+    normalizeSpec.scale = {1.0f / 58.4f, 1.0f / 57.1f, 1.0f / 57.4f};
+
+    const bool defaultOk = checkSpec(InputAdapter::Spec{});
+    const bool normalizeOk = checkSpec(normalizeSpec);
+    return defaultOk && normalizeOk ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+/*
+ * byte input engine (trt_utils/inputAdapter.h) 경로의 offline 검증.
+ * 1. kINT8 input의 dynamic range로 TensorRT가 적용하는 scale이 1인지
+ * 2. 같은 crop의 float preprocess 결과와, byte preprocess 결과를 InputAdapter::emulate()로
+ *    변환한 결과가 byte 반올림 오차 이내인지
+ * 3. CPU backend에서 byte input agent와 float input agent의 결과가 같은지 (2의 오차 이내)
+ * prepend()가 만드는 network 자체는 GPU가 필요하다. (inputAdapterGpu_test.cpp)
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "infer-agents/AgentSpecs.hpp"
+#include "taillight/CropPreproc.hpp"
+
+namespace {
+
+constexpr int kImgH = 240;
+constexpr int kImgW = 320;
+constexpr int kNumRois = 100;
+
+std::vector<nvinfer1::DataType> byteTypes() {
+    std::vector<nvinfer1::DataType> types{nvinfer1::DataType::kINT8};
+#if TRT_UTILS_HAS_UINT8
+    types.push_back(nvinfer1::DataType::kUINT8);
+#endif
+    return types;
+}
+
+// float 대비 byte 경로의 최대 오차 (pixel 값 단위). 반올림 0.5, kINT8은 pixel 0이 1로 전달된다.
+float tolerancePixel(nvinfer1::DataType type) {
+    return type == nvinfer1::DataType::kINT8 ? 1.0f : 0.5f;
+}
+
+std::vector<InputAdapter::Spec> specs() {
+    InputAdapter::Spec deprecatedSpec; // (x / 255 - 0.5) * 4, BGR 유지
+    deprecatedSpec.swapRB = false;
+    deprecatedSpec.mean = {127.5f, 127.5f, 127.5f};
+    deprecatedSpec.scale = {4.0f / 255, 4.0f / 255, 4.0f / 255};
+
+    InputAdapter::Spec channelSpec; // channel 별로 다른 계수
+    channelSpec.mean = {123.7f, 116.3f, 103.5f};
+    channelSpec.scale = {1.0f / 58.4f, 1.0f / 57.1f, 1.0f / 57.4f};
+    return {InputAdapter::Spec{}, deprecatedSpec, channelSpec};
+}
+
+// 이미지 밖으로 나가는 roi와 확대 / 축소를 모두 포함한다.
+std::vector<cv::Rect> randomRois(std::mt19937 &rng) {
+    auto uniform = [&rng](int lo, int hi) {
+        return std::uniform_int_distribution<int>(lo, hi)(rng);
+    };
+    std::vector<cv::Rect> rois;
+    for (int i = 0; i < kNumRois; ++i) {
+        rois.emplace_back(
+            uniform(-20, kImgW - 10), uniform(-20, kImgH - 10), uniform(5, 300), uniform(5, 200));
+    }
+    return rois;
+}
+
+// TensorRT는 kINT8 input을 max(|min|, |max|) / 127로 dequantize 한다.
+bool checkInt8Scale() {
+    const float trtScale =
+        std::max(std::abs(InputAdapter::kInt8RangeMin), std::abs(InputAdapter::kInt8RangeMax)) /
+        127.0f;
+    if (trtScale != 1.0f || InputAdapter::int8Scale() != trtScale) {
+        std::cout << "FAIL int8 input scale " << trtScale << " (expected 1)" << std::endl;
+        return false;
+    }
+
+    // host가 쓸 수 있는 값 (-127 ~ 127)은 pixel 1 ~ 255로 그대로 복원된다.
+    const int8_t bytes[3] = {-127, 0, 127};
+    float pixels[3];
+    InputAdapter::Spec identity;
+    identity.swapRB = false;
+    identity.scale = {1.0f, 1.0f, 1.0f};
+    InputAdapter::emulate(identity, nvinfer1::DataType::kINT8, bytes, pixels, 1);
+    if (pixels[0] != 1.0f || pixels[1] != 128.0f || pixels[2] != 255.0f) {
+        std::cout << "FAIL int8 input dequantize" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkParity(const cv::Mat &img, const std::vector<cv::Rect> &rois) {
+    bool ok = true;
+    for (const InputAdapter::Spec &spec : specs()) {
+        for (const nvinfer1::DataType type : byteTypes()) {
+            const CropPreproc::Params floatParams = CropPreproc::paramsFor(
+                UNetCfg::inH, UNetCfg::inW, nvinfer1::DataType::kFLOAT, spec);
+            const CropPreproc::Params byteParams =
+                CropPreproc::paramsFor(UNetCfg::inH, UNetCfg::inW, type, spec);
+            std::vector<float> reference(floatParams.numEl());
+            std::vector<uint8_t> bytes(byteParams.numEl());
+            std::vector<float> emulated(floatParams.numEl());
+
+            float maxErr = 0.0f; // pixel 값 (0 ~ 255) 단위
+            for (const cv::Rect &roi : rois) {
+                CropPreproc::cropResize(img, roi, floatParams, reference.data());
+                CropPreproc::cropResize(img, roi, byteParams, bytes.data());
+                InputAdapter::emulate(
+                    spec, type, bytes.data(), emulated.data(), UNetCfg::inH * UNetCfg::inW);
+                for (size_t i = 0; i < reference.size(); ++i) {
+                    const float err = std::abs(reference[i] - emulated[i]) / spec.scale[i % 3];
+                    maxErr = std::max(maxErr, err);
+                }
+            }
+            std::cout << (type == nvinfer1::DataType::kINT8 ? "int8" : "uint8")
+                      << ": max error " << maxErr << " pixel" << std::endl;
+            if (maxErr > tolerancePixel(type) + 1e-3f) {
+                std::cout << "FAIL float / byte preprocess mismatch" << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+// CPU backend에서 같은 crop의 regress 결과를 float input agent와 byte input agent로 비교한다.
+std::vector<std::array<float, 4>>
+runCpuRegress(nvinfer1::DataType type, const cv::Mat &img, const std::vector<cv::Rect> &rois) {
+    InferenceParams params;
+    params.backend = InferBackendType::kCpu;
+    params.cpuImageInputType = type;
+    RegressInferAgent agent(params);
+    if (agent.inputType() != type) {
+        std::cout << "FAIL cpu agent input type" << std::endl;
+        exit(1);
+    }
+
+    const CropPreproc::Params preproc = CropPreproc::paramsFor(
+        RegCfg::inH, RegCfg::inW, agent.inputType(), InputAdapter::Spec{});
+    for (int i = 0; i < RegCfg::inB; ++i) {
+        CropPreproc::cropResize(img, rois[i], preproc, agent.inputSlot(i));
+    }
+    return agent.infer(RegCfg::inB);
+}
+
+bool checkCpuByteAgent(const cv::Mat &img, const std::vector<cv::Rect> &rois) {
+    const auto reference = runCpuRegress(nvinfer1::DataType::kFLOAT, img, rois);
+    bool ok = true;
+    for (const nvinfer1::DataType type : byteTypes()) {
+        const auto boxes = runCpuRegress(type, img, rois);
+        // CPU backend output 오차 <= 0.5 * input 오차 (CpuBackend.hpp)
+        const float bound = 0.5f * tolerancePixel(type) * InputAdapter::Spec{}.scale[0] + 1e-6f;
+        float maxErr = 0.0f;
+        for (size_t b = 0; b < boxes.size(); ++b) {
+            for (int k = 0; k < 4; ++k) {
+                maxErr = std::max(maxErr, std::abs(boxes[b][k] - reference[b][k]));
+            }
+        }
+        std::cout << (type == nvinfer1::DataType::kINT8 ? "int8" : "uint8")
+                  << ": cpu agent max box error " << maxErr << std::endl;
+        if (maxErr > bound) {
+            std::cout << "FAIL cpu byte agent differs from float agent" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(11);
+    std::vector<uint8_t> pixels(kImgH * kImgW * 3);
+    for (uint8_t &pixel : pixels) {
+        pixel = static_cast<uint8_t>(rng());
+    }
+    const cv::Mat img(kImgH, kImgW, CV_8UC3, pixels.data());
+    const std::vector<cv::Rect> rois = randomRois(rng);
+
+    const bool scaleOk = checkInt8Scale();
+    const bool parityOk = checkParity(img, rois);
+    const bool agentOk = checkCpuByteAgent(img, rois);
+    return scaleOk && parityOk && agentOk ? 0 : 1;
+}
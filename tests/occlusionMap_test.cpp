@@ -0,0 +1,100 @@
+/*
+ * occlusion 구조 (bitmask, row_prefix, rect_union)의 randomized 비교.
+ * 같은 fill / count 순서를 ArrayXXb reference와 함께 적용하여 모든 count가 같은지 확인한다.
+ * 크기가 같은 reset (memory 재사용), 이미지 밖으로 나가는 사각형, 64의 배수가 아닌 폭,
+ * 1 row span (silhouette)을 포함한다.
+ */
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "taillight/OcclusionMap.hpp"
+
+namespace {
+
+constexpr int kNumSizes = 40;
+constexpr int kFramesPerSize = 4;
+constexpr int kOpsPerFrame = 60;
+
+struct Rect {
+    int row;
+    int col;
+    int height;
+    int width;
+};
+
+// 이미지 밖 (음수, 끝 너머)까지 걸칠 수 있는 사각형
+Rect randomRect(std::mt19937 &rng, int rows, int cols) {
+    auto uniform = [&rng](int lo, int hi) {
+        return std::uniform_int_distribution<int>(lo, hi)(rng);
+    };
+    if (uniform(0, 3) == 0) {
+        const int col = uniform(-8, cols);
+        return Rect{uniform(0, rows - 1), col, 1, uniform(0, cols / 2 + 1)};
+    }
+    return Rect{
+        uniform(-rows / 4, rows),
+        uniform(-cols / 4, cols),
+        uniform(0, rows / 2 + 1),
+        uniform(0, cols / 2 + 1)};
+}
+
+// reference. 이미지 밖을 잘라낸 block
+bool clipped(const Rect &rect, int rows, int cols, Rect &out) {
+    out.row = std::max(rect.row, 0);
+    out.col = std::max(rect.col, 0);
+    out.height = std::min(rect.row + rect.height, rows) - out.row;
+    out.width = std::min(rect.col + rect.width, cols) - out.col;
+    return out.height > 0 && out.width > 0;
+}
+
+bool runMethod(const std::string &method) {
+    std::mt19937 rng(7);
+    std::unique_ptr<OcclusionMap> occMap = createOcclusionMap(method);
+    for (int s = 0; s < kNumSizes; ++s) {
+        const int rows = std::uniform_int_distribution<int>(1, 160)(rng);
+        const int cols = std::uniform_int_distribution<int>(1, 300)(rng);
+        for (int frame = 0; frame < kFramesPerSize; ++frame) {
+            occMap->reset(rows, cols);
+            ArrayXXb reference = ArrayXXb::Zero(rows, cols);
+            for (int op = 0; op < kOpsPerFrame; ++op) {
+                const Rect rect = randomRect(rng, rows, cols);
+                Rect block;
+                const bool inside = clipped(rect, rows, cols, block);
+
+                const int expected =
+                    inside ? static_cast<int>(
+                                 reference.block(block.row, block.col, block.height, block.width)
+                                     .count())
+                           : 0;
+                const int actual = occMap->count(rect.row, rect.col, rect.height, rect.width);
+                if (actual != expected) {
+                    std::cout << "FAIL " << method << " " << rows << "x" << cols << " count("
+                              << rect.row << ", " << rect.col << ", " << rect.height << ", "
+                              << rect.width << "): " << actual << " != " << expected << std::endl;
+                    return false;
+                }
+
+                if (op % 2 == 0) {
+                    occMap->fill(rect.row, rect.col, rect.height, rect.width);
+                    if (inside) {
+                        reference.block(block.row, block.col, block.height, block.width) = true;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    for (const char *method : {"bitmask", "row_prefix", "rect_union"}) {
+        const bool methodOk = runMethod(method);
+        std::cout << method << (methodOk ? " ok" : " FAIL") << std::endl;
+        ok = methodOk && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+/*
+ * trt_utils/simdKernels.h의 AVX2 / SSE4.1 구현이 scalar (reference)와 bit 단위로 같은지 확인한다.
+ * vector 폭을 넘는 tail이 남는 홀수 길이, 1 / 3 / 4 channel, in-place swapRB,
+ * f16의 모든 bit pattern과 f32의 특수 값 (inf, nan, subnormal, overflow, rounding tie)을 포함한다.
+ * 실행 중인 CPU가 지원하지 않는 단계는 건너뛴다.
+ */
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "trt_utils/simdKernels.h"
+
+namespace {
+
+using namespace SimdKernels;
+
+const size_t kLengths[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 23, 24, 25, 31, 33, 63, 65, 257};
+
+// 한 ISA 단계의 kernel 묶음
+struct Kernels {
+    Isa isa;
+    void (*u8ToF32)(const uint8_t *, float *, size_t, float, float);
+    void (*hwcToChw)(const float *, float *, size_t, int);
+    void (*chwToHwc)(const float *, float *, size_t, int);
+    void (*swapRB)(const float *, float *, size_t);
+    void (*f32ToF16)(const float *, uint16_t *, size_t);
+    void (*f16ToF32)(const uint16_t *, float *, size_t);
+};
+
+template <typename T> bool sameBits(const std::vector<T> &lhs, const std::vector<T> &rhs) {
+    return lhs.size() == rhs.size() &&
+           std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+}
+
+bool report(const Kernels &kernels, const char *kernel, size_t n, int channels, bool ok) {
+    if (!ok) {
+        std::cout << "FAIL " << isaName(kernels.isa) << " " << kernel << " n " << n
+                  << " channels " << channels << std::endl;
+    }
+    return ok;
+}
+
+std::vector<float> randomFloats(std::mt19937 &rng, size_t n) {
+    std::uniform_real_distribution<float> dist(-300.0f, 300.0f);
+    std::vector<float> values(n);
+    for (float &value : values) {
+        value = dist(rng);
+    }
+    return values;
+}
+
+// f32 -> f16 변환의 특수 값
+std::vector<float> specialFloats() {
+    std::vector<float> values = {
+        0.0f,
+        -0.0f,
+        1.0f,
+        -2.5f,
+        65504.0f,
+        65519.0f,                     // 65504로 내림
+        65520.0f,                     // inf로 올림
+        1e10f,
+        -1e10f,
+        std::ldexp(1.0f, -14),        // 최소 normal
+        std::ldexp(1.0f, -24),        // 최소 subnormal
+        std::ldexp(1.0f, -25),        // 0으로 내림 (tie, even)
+        std::ldexp(1.5f, -25),        // 최소 subnormal로 올림
+        std::ldexp(3.0f, -25),        // tie -> even
+        1.0f + std::ldexp(1.0f, -11), // tie -> even (1.0)
+        1.0f + std::ldexp(3.0f, -11), // tie -> even (올림)
+        std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::quiet_NaN(),
+        -std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::denorm_min(),
+    };
+    // payload가 있는 nan
+    for (uint32_t bits : {0x7fc12345U, 0xffa00001U, 0x7f800001U}) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        values.push_back(value);
+    }
+    return values;
+}
+
+bool checkKernels(const Kernels &ref, const Kernels &simd) {
+    std::mt19937 rng(5);
+    bool ok = true;
+
+    for (const size_t n : kLengths) {
+        // u8 -> f32
+        std::vector<uint8_t> bytes(n);
+        for (uint8_t &byte : bytes) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        std::vector<float> expected(n);
+        std::vector<float> actual(n);
+        ref.u8ToF32(bytes.data(), expected.data(), n, 1.0f / 255.0f, -0.5f);
+        simd.u8ToF32(bytes.data(), actual.data(), n, 1.0f / 255.0f, -0.5f);
+        ok = report(simd, "u8ToF32", n, 1, sameBits(expected, actual)) && ok;
+
+        // HWC <-> CHW
+        for (const int channels : {1, 3, 4}) {
+            const std::vector<float> src = randomFloats(rng, n * channels);
+            std::vector<float> expectedOut(n * channels);
+            std::vector<float> actualOut(n * channels);
+            ref.hwcToChw(src.data(), expectedOut.data(), n, channels);
+            simd.hwcToChw(src.data(), actualOut.data(), n, channels);
+            ok = report(simd, "hwcToChw", n, channels, sameBits(expectedOut, actualOut)) && ok;
+
+            ref.chwToHwc(src.data(), expectedOut.data(), n, channels);
+            simd.chwToHwc(src.data(), actualOut.data(), n, channels);
+            ok = report(simd, "chwToHwc", n, channels, sameBits(expectedOut, actualOut)) && ok;
+        }
+
+        // swapRB (3 channel), 별도 buffer와 in-place
+        const std::vector<float> rgb = randomFloats(rng, n * 3);
+        std::vector<float> expectedRgb(n * 3);
+        std::vector<float> actualRgb(n * 3);
+        ref.swapRB(rgb.data(), expectedRgb.data(), n);
+        simd.swapRB(rgb.data(), actualRgb.data(), n);
+        ok = report(simd, "swapRB", n, 3, sameBits(expectedRgb, actualRgb)) && ok;
+
+        std::vector<float> inPlace = rgb;
+        simd.swapRB(inPlace.data(), inPlace.data(), n);
+        ok = report(simd, "swapRB(in-place)", n, 3, sameBits(expectedRgb, inPlace)) && ok;
+
+        // f32 -> f16
+        const std::vector<float> floats = randomFloats(rng, n);
+        std::vector<uint16_t> expectedHalf(n);
+        std::vector<uint16_t> actualHalf(n);
+        ref.f32ToF16(floats.data(), expectedHalf.data(), n);
+        simd.f32ToF16(floats.data(), actualHalf.data(), n);
+        ok = report(simd, "f32ToF16", n, 1, sameBits(expectedHalf, actualHalf)) && ok;
+    }
+
+    // f32 -> f16 특수 값. vector 폭을 넘도록 반복한다.
+    std::vector<float> specials = specialFloats();
+    specials.insert(specials.end(), specials.begin(), specials.end());
+    std::vector<uint16_t> expectedHalf(specials.size());
+    std::vector<uint16_t> actualHalf(specials.size());
+    ref.f32ToF16(specials.data(), expectedHalf.data(), specials.size());
+    simd.f32ToF16(specials.data(), actualHalf.data(), specials.size());
+    const bool specialOk = sameBits(expectedHalf, actualHalf);
+    ok = report(simd, "f32ToF16(special)", specials.size(), 1, specialOk) && ok;
+
+    // f16 -> f32, 모든 bit pattern (+ tail 3개)
+    std::vector<uint16_t> halves(65536 + 3);
+    for (size_t i = 0; i < halves.size(); ++i) {
+        halves[i] = static_cast<uint16_t>(i);
+    }
+    std::vector<float> expectedFloat(halves.size());
+    std::vector<float> actualFloat(halves.size());
+    ref.f16ToF32(halves.data(), expectedFloat.data(), halves.size());
+    simd.f16ToF32(halves.data(), actualFloat.data(), halves.size());
+    const bool allHalvesOk = sameBits(expectedFloat, actualFloat);
+    ok = report(simd, "f16ToF32(all)", halves.size(), 1, allHalvesOk) && ok;
+
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    const Kernels scalarKernels{
+        Isa::kScalar,
+        scalar::u8ToF32,
+        scalar::hwcToChw,
+        scalar::chwToHwc,
+        scalar::swapRB,
+        scalar::f32ToF16,
+        scalar::f16ToF32};
+
+    std::vector<Kernels> simdKernels;
+#if defined(TRT_UTILS_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) {
+        // SSE4.1 단계의 f16 변환은 scalar
+        simdKernels.push_back(Kernels{
+            Isa::kSSE41,
+            sse41::u8ToF32,
+            sse41::hwcToChw,
+            sse41::chwToHwc,
+            sse41::swapRB,
+            scalar::f32ToF16,
+            scalar::f16ToF32});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")) {
+        simdKernels.push_back(Kernels{
+            Isa::kAVX2,
+            avx2::u8ToF32,
+            avx2::hwcToChw,
+            avx2::chwToHwc,
+            avx2::swapRB,
+            avx2::f32ToF16,
+            avx2::f16ToF32});
+    }
+#endif
+    if (simdKernels.empty()) {
+        std::cout << "no SIMD kernels on this CPU, scalar only" << std::endl;
+    }
+
+    bool ok = true;
+    for (const Kernels &kernels : simdKernels) {
+        const bool isaOk = checkKernels(scalarKernels, kernels);
+        std::cout << isaName(kernels.isa) << (isaOk ? " ok" : " FAIL") << std::endl;
+        ok = isaOk && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+/*
+ * CNN3D scheduling 우선순위 (TrackedInst::schedPriority) 검증.
+ * checkpoint에서 복원된 track은 다음 detection 전까지 거리가 무한대이므로
+ * sched_dist_weight = 0 (staleness만 사용)에서도 우선순위가 유한해야 한다. (NaN이면 정렬이 깨진다)
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "TrackerCheckpoint.hpp"
+
+namespace {
+
+constexpr const char *kCheckpointPath = "trackSched_test.ckpt";
+constexpr float kLiveDist = 5.0f;
+constexpr int64_t kFrameIdx = 10;
+
+// detection이 있는 track 하나를 저장하고 다시 읽어 복원된 track을 만든다.
+bool restoreTrack(EmbeddingPool &pool, std::vector<TrackedInst> &restored) {
+    EmbeddingPool savePool(ENCODED_TAIL_SIZE, FeatStorage::kFP32, CNN3DCfg::inSeqLen);
+    std::vector<TrackedInst> tracks;
+    tracks.reserve(1);
+    std::vector<float> frame(ENCODED_TAIL_SIZE, 0.25f);
+    const int slot = savePool.store(frame.data());
+    tracks.emplace_back(7, slot, kLiveDist, 0, savePool);
+    savePool.release(slot);
+
+    TrackerCheckpoint checkpoint;
+    if (!checkpoint.saveAsync(kCheckpointPath, tracks, savePool)) {
+        return false;
+    }
+    checkpoint.wait();
+
+    restored.reserve(1);
+    const bool ok = TrackerCheckpoint::load(kCheckpointPath, 60.0, 1, pool, restored);
+    std::remove(kCheckpointPath);
+    return ok && restored.size() == 1;
+}
+
+} // namespace
+
+int main() {
+    EmbeddingPool pool(ENCODED_TAIL_SIZE, FeatStorage::kFP32, CNN3DCfg::inSeqLen);
+    std::vector<TrackedInst> tracks;
+    if (!restoreTrack(pool, tracks)) {
+        std::cout << "FAIL checkpoint restore" << std::endl;
+        return 1;
+    }
+    const int slot = pool.store(std::vector<float>(ENCODED_TAIL_SIZE, 0.5f).data());
+    tracks.emplace_back(8, slot, kLiveDist, 0, pool);
+    pool.release(slot);
+
+    const TrackedInst &restored = tracks[0];
+    const TrackedInst &live = tracks[1];
+    if (std::isfinite(restored.dist())) {
+        std::cout << "FAIL restored track has a known distance" << std::endl;
+        return 1;
+    }
+
+    bool ok = true;
+    for (const float weight : {0.0f, 0.5f}) {
+        const float restoredPriority = restored.schedPriority(kFrameIdx, weight);
+        const float livePriority = live.schedPriority(kFrameIdx, weight);
+        const float staleness = static_cast<float>(kFrameIdx);
+        std::cout << "weight " << weight << ": restored " << restoredPriority << ", live "
+                  << livePriority << std::endl;
+        if (!std::isfinite(restoredPriority) || restoredPriority != staleness) {
+            std::cout << "FAIL restored track priority" << std::endl;
+            ok = false;
+        }
+        if (livePriority != staleness - weight * kLiveDist) {
+            std::cout << "FAIL live track priority" << std::endl;
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}